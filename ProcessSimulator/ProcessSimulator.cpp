@@ -11,21 +11,32 @@ using namespace std;
 const int numProcLists = 100;
 const int n = 10;
 
+//quanta for the Multilevel Feedback Queue runs
+const int timeQuantum = 4;
+const int highQuantum = 2;
+const int lowQuantum = 5;
+
+//Writes an experiment spec running the Multilevel Feedback Queue on every process list and has
+//the simulator run it headless (see experiment.h)
 int main()
 {
     ofstream f;
-    string command = "../program ";
     string procList = "procList";
-    string curList;
-    string end = ".txt 8";
-    char c;
-    for(int i=0; i<numProcLists; i++)
-    {
-        command = "../program ";
-        curList = procList + to_string(i);
-        command = command + curList + end;
-        cout<<command<<endl;
-        system(command.c_str());
-    }
-    return 0;   
-}
\ No newline at end of file
+    string specName = "experiment.spec";
+    string command = "../program experiment=" + specName;
+
+    f.open(specName, fstream::out);
+    //procCreate numbers the lists from 1
+    for(int i=1; i<=numProcLists; i++)
+        f << "workload = " << procList << i << ".txt" << endl;
+    f << "policies = 8" << endl
+      << "quantum = " << timeQuantum << endl
+      << "high = " << highQuantum << endl
+      << "low = " << lowQuantum << endl
+      << "output = results.csv" << endl
+      << "threads = 0" << endl;
+    f.close();
+
+    cout<<command<<endl;
+    return system(command.c_str());
+}
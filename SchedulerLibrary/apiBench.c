@@ -0,0 +1,139 @@
+/*  C interface benchmark: calls per second through libscheduler.so for each policy, driving an
+    instance a time step at a time (add the arrivals, ask for the next process, tick) and from
+    decision to decision (advance to when the decision runs out or the next process arrives).
+    Usage: apiBench [processes]
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<time.h>
+#include "schedulerApi.h"
+
+static const char* const POLICY_NAMES[] = {"", "Round Robin", "Shortest Process Next", "Shortest Remaining Time",
+    "Highest Response Ratio Next", "Modified HRRN", "First In First Out", "Multilevel Queue", "Multilevel Feedback Queue",
+    "Earliest Deadline First", "Non-preemptive EDF", "Least Laxity First"};
+
+//a process of the generated workload: one CPU burst, or CPU, IO, CPU
+typedef struct Arrival
+{
+    scheduler_process p;
+    int bursts[3];
+} Arrival;
+
+static uint64_t state = 88172645463325252ULL;
+
+static int randomBelow(int n)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (int)(state % (uint64_t)n);
+}
+
+//processes arriving about every 9 steps needing about 8 steps each, a quarter with IO
+static void generate(Arrival* workload, int n)
+{
+    int start = 0;
+    for(int i = 0; i < n; ++i)
+    {
+        Arrival* a = &workload[i];
+        start += randomBelow(19);
+        a->p.start_time = start;
+        a->p.cpu_time = 1 + randomBelow(16);
+        a->p.priority = randomBelow(10);
+        a->p.deadline = a->p.cpu_time * (2 + randomBelow(8));
+        a->p.bursts = NULL;
+        a->p.num_bursts = 0;
+        if(randomBelow(4) == 0 && a->p.cpu_time > 1)
+        {
+            a->bursts[0] = a->p.cpu_time / 2;
+            a->bursts[1] = 1 + randomBelow(20);
+            a->bursts[2] = a->p.cpu_time - a->bursts[0];
+            a->p.num_bursts = 3;
+        }
+    }
+}
+
+static double seconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+//Runs workload through a new instance of policy. Returns the calls made and sets the time taken
+//and the mean turnaround time, or returns -1 on an error.
+static long long run(int policy, Arrival* workload, int n, int byTick, double* elapsed, double* turnaround)
+{
+    scheduler_params params = {3, 4, 8, n, 3};
+    scheduler_instance* s = scheduler_create(policy, &params);
+    if(!s)
+        return -1;
+    long long calls = 1;
+    int added = 0, done = 0, until;
+    double start = seconds();
+    while(done >= 0 && done < n)
+    {
+        int now = scheduler_now(s);
+        for(; added < n && workload[added].p.start_time <= now && done >= 0; ++added, ++calls)
+        {
+            workload[added].p.bursts = workload[added].bursts;
+            if(scheduler_add_process(s, &workload[added].p) < 0)
+                done = -1;
+        }
+        if(done < 0 || scheduler_next(s, &until) < SCHEDULER_IDLE)
+            break;
+        if(byTick)
+            done = scheduler_tick(s);
+        else
+        {
+            int to = added < n && workload[added].p.start_time < until ? workload[added].p.start_time : until;
+            done = scheduler_advance(s, to == SCHEDULER_NEVER ? now + 1 : to);
+        }
+        calls += 3;
+    }
+    if(done != n)
+    {
+        scheduler_destroy(s);
+        return -1;
+    }
+    *elapsed = seconds() - start;
+    *turnaround = 0;
+    for(int i = 0; i < n; ++i)
+        *turnaround += (double)(scheduler_finish_time(s, i) + 1 - workload[i].p.start_time) / n;
+    scheduler_destroy(s);
+    return calls + 1;
+}
+
+int main(int argc, char* argv[])
+{
+    int n = argc > 1 ? atoi(argv[1]) : 100000;
+    Arrival* workload = malloc(sizeof(Arrival) * (n > 0 ? n : 1));
+    if(n <= 0 || !workload)
+        return -1;
+    generate(workload, n);
+
+    printf("%d processes, a quarter with IO, through the C interface\n\n", n);
+    printf("Policy                      | By tick Mcalls/s | By decision Mcalls/s | Calls per process | Mean turnaround |\n");
+    printf("--------------------------------------------------------------------------------------------------------------\n");
+    for(int policy = SCHEDULER_ROUND_ROBIN; policy <= SCHEDULER_LEAST_LAXITY_FIRST; ++policy)
+    {
+        double tickTime, decisionTime;
+        double tickTurnaround, decisionTurnaround;
+        long long tickCalls = run(policy, workload, n, 1, &tickTime, &tickTurnaround);
+        long long decisionCalls = run(policy, workload, n, 0, &decisionTime, &decisionTurnaround);
+        if(tickCalls < 0 || decisionCalls < 0)
+        {
+            printf("%-27s | failed\n", POLICY_NAMES[policy]);
+            continue;
+        }
+        printf("%-27s | %16.2f | %20.2f | %17.2f | %15.2f |%s\n", POLICY_NAMES[policy], tickCalls / tickTime / 1e6,
+               decisionCalls / decisionTime / 1e6, (double)decisionCalls / n, decisionTurnaround,
+               tickTurnaround == decisionTurnaround ? "" : " (differs by tick)");
+    }
+    free(workload);
+    return 0;
+}
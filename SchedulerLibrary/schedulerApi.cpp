@@ -0,0 +1,251 @@
+#include<new>          // bad_alloc
+#include<type_traits>  // decay_t
+#include<functional>   // greater
+#include "schedulerApi.h"
+#include "../simulator.h"
+
+//What the entry points call on an instance, whatever its policy
+struct scheduler_instance
+{
+    virtual ~scheduler_instance() {}
+    virtual int add(const scheduler_process& p) = 0;
+    virtual int advance(int time) = 0;
+    virtual int next(int* until) = 0;
+    virtual int now() const = 0;
+    virtual int finishTime(int process) const = 0;
+};
+
+namespace
+{
+
+//makes pool the calling thread's burst pool while it lives
+class PoolScope
+{
+public:
+    explicit PoolScope(vector<int>& pool) : saved(threadBurstPool()) { threadBurstPool() = &pool; }
+    ~PoolScope() { threadBurstPool() = saved; }
+
+private:
+    vector<int>* saved;
+};
+
+//The slice loop of simulateOnline() run a call at a time, with the processes added by the caller.
+//A decision is made with no arrival in sight; adding a process that arrives before the decision
+//runs out cuts it short there, which gives the schedule a decision at the arrival would have.
+//advance() leaves the next decision to be made where it stops, so processes added there are in it.
+template<class Policy>
+class PolicyInstance : public scheduler_instance
+{
+public:
+    PolicyInstance(const Policy& policy, const scheduler_params& params)
+        : policy(policy), capacity(params.max_processes), maxBursts(params.max_bursts), curTime(0), numDone(0), decided(false),
+          running(-1), sliceEnd(0)
+    {
+        this->policy.reserve(capacity);
+        procList.reserve(capacity);
+        pending.reserve(capacity);
+        blocked.reserve(capacity);
+        bursts.reserve(maxBursts);
+        //setBursts() stores the estimate scale, group, deadline, working set, bursts and END_OF_BURSTS
+        pool.reserve(1 + static_cast<size_t>(capacity) * (maxBursts + 5));
+        pool.push_back(0);
+    }
+
+    int add(const scheduler_process& p) override
+    {
+        if(static_cast<int>(procList.size()) >= capacity)
+            return SCHEDULER_ERROR_FULL;
+        if(p.start_time < 0 || p.priority < 0 || p.priority > 9 || p.deadline < 0 || p.num_bursts < 0 || p.num_bursts > maxBursts
+           || (p.num_bursts > 0 && (!p.bursts || p.num_bursts % 2 == 0)) || (p.num_bursts == 0 && p.cpu_time <= 0))
+            return SCHEDULER_ERROR_INVALID;
+        Process proc;
+        proc.startTime = p.start_time;
+        proc.totalTimeNeeded = p.num_bursts ? 0 : p.cpu_time;
+        proc.priority = p.priority;
+        bursts.clear();
+        for(int i = 0; i < p.num_bursts; ++i)
+        {
+            if(p.bursts[i] < (i % 2 == 0 ? 1 : 0))
+                return SCHEDULER_ERROR_INVALID;
+            if(i % 2 == 0)
+                proc.totalTimeNeeded += p.bursts[i];
+            bursts.push_back(p.bursts[i]);
+        }
+        if(bursts.size() == 1)
+            bursts.clear();
+        PoolScope scope(pool);
+        setBursts(proc, 0, bursts, p.deadline);
+        resetBursts(proc);
+
+        int idx = procList.size();
+        procList.push_back(proc);
+        pending.push_back(make_pair(proc.startTime, idx));
+        push_heap(pending.begin(), pending.end(), greater<pair<int, int>>());
+        //one already due waits for the next decision, a step on
+        if(decided && proc.startTime < sliceEnd)
+            sliceEnd = max(proc.startTime, curTime + 1);
+        return idx;
+    }
+
+    int advance(int time) override
+    {
+        if(time < curTime)
+            return SCHEDULER_ERROR_INVALID;
+        PoolScope scope(pool);
+        while(curTime < time)
+        {
+            if(!decided)
+                decide();
+            int end = min(sliceEnd, time);
+            if(running >= 0 && chargeRun(procList, running, curTime, end - curTime, blocked))
+                ++numDone;
+            curTime = end;
+            decided = false;
+        }
+        return numDone;
+    }
+
+    int next(int* until) override
+    {
+        if(!decided)
+        {
+            PoolScope scope(pool);
+            decide();
+        }
+        if(until)
+            *until = sliceEnd;
+        return running;
+    }
+
+    int now() const override { return curTime; }
+
+    int finishTime(int process) const override
+    {
+        if(process < 0 || process >= static_cast<int>(procList.size()))
+            return SCHEDULER_ERROR_INVALID;
+        return procList[process].isDone ? procList[process].timeFinished : -1;
+    }
+
+private:
+    //admits what is due and asks the policy what runs from the current time
+    void decide()
+    {
+        while(!pending.empty() && pending.front().first <= curTime)
+        {
+            admitArrival(policy, pending.front().second, curTime, 0, procList);
+            pop_heap(pending.begin(), pending.end(), greater<pair<int, int>>());
+            pending.pop_back();
+        }
+        wakeBlocked(policy, blocked, curTime, 0, procList);
+        int nextWakeup = blocked.nextExpiry();
+        int nextArrival = min(pending.empty() ? NEVER : pending.front().first, nextWakeup);
+
+        Slice slice = policy.nextSlice(curTime, nextArrival, procList);
+        decided = true;
+        if(slice.idx < 0 || slice.idx >= static_cast<int>(procList.size()))
+        {
+            running = SCHEDULER_IDLE;
+            sliceEnd = nextArrival;
+            return;
+        }
+        running = slice.idx;
+        sliceEnd = curTime + max(min(slice.length, min(slice.preemptAt, nextWakeup) - curTime), 1);
+    }
+
+    Policy policy;
+    int capacity;
+    int maxBursts;
+    int curTime;
+    int numDone;
+    bool decided;                       //whether running and sliceEnd hold for the current time
+    int running;                        //process the decision runs, SCHEDULER_IDLE for none
+    int sliceEnd;                       //time the decision runs out
+    vector<Process> procList;
+    vector<pair<int, int>> pending;     //start time and index of the processes not admitted yet, a min heap
+    TimerWheel blocked;                 //processes waiting for IO
+    vector<int> pool;                   //burst pool of the processes
+    vector<int> bursts;                 //the bursts of the process being added
+};
+
+}
+
+scheduler_instance* scheduler_create(int policy, const scheduler_params* params)
+{
+    if(!params || params->max_processes <= 0 || params->max_bursts < 0)
+        return nullptr;
+    bool quanta = policy == SCHEDULER_ROUND_ROBIN || policy == SCHEDULER_MULTILEVEL_QUEUE || policy == SCHEDULER_MULTILEVEL_FEEDBACK_QUEUE;
+    if(quanta && params->quantum <= 0)
+        return nullptr;
+    if(policy == SCHEDULER_MULTILEVEL_FEEDBACK_QUEUE && (params->high_quantum <= 0 || params->low_quantum <= 0))
+        return nullptr;
+    scheduler_instance* s = nullptr;
+    try
+    {
+        withScheduler(policy, params->quantum, params->high_quantum, params->low_quantum, [&](auto& sched)
+        {
+            s = new PolicyInstance<decay_t<decltype(sched)>>(sched, *params);
+        });
+    }
+    catch(const bad_alloc&)
+    {
+        return nullptr;
+    }
+    return s;
+}
+
+void scheduler_destroy(scheduler_instance* s)
+{
+    delete s;
+}
+
+int scheduler_add_process(scheduler_instance* s, const scheduler_process* p)
+{
+    if(!s || !p)
+        return SCHEDULER_ERROR_INVALID;
+    return s->add(*p);
+}
+
+int scheduler_advance(scheduler_instance* s, int time)
+{
+    if(!s)
+        return SCHEDULER_ERROR_INVALID;
+    try
+    {
+        return s->advance(time);
+    }
+    catch(const bad_alloc&)
+    {
+        return SCHEDULER_ERROR_NO_MEMORY;
+    }
+}
+
+int scheduler_tick(scheduler_instance* s)
+{
+    if(!s)
+        return SCHEDULER_ERROR_INVALID;
+    return scheduler_advance(s, s->now() + 1);
+}
+
+int scheduler_next(scheduler_instance* s, int* until)
+{
+    if(!s)
+        return SCHEDULER_ERROR_INVALID;
+    try
+    {
+        return s->next(until);
+    }
+    catch(const bad_alloc&)
+    {
+        return SCHEDULER_ERROR_NO_MEMORY;
+    }
+}
+
+int scheduler_now(const scheduler_instance* s)
+{
+    return s ? s->now() : SCHEDULER_ERROR_INVALID;
+}
+
+int scheduler_finish_time(const scheduler_instance* s, int process)
+{
+    return s ? s->finishTime(process) : SCHEDULER_ERROR_INVALID;
+}
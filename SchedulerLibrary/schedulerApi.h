@@ -0,0 +1,109 @@
+#ifndef SCHEDULERAPI_H
+#define SCHEDULERAPI_H
+
+//C interface to the simulator's scheduling policies, for programs that want a policy's decisions
+//in process rather than from a simulation run. Link with libscheduler.so.
+//
+//An instance is one policy scheduling its own set of processes on one processor, in whole time
+//steps from time 0. The caller adds processes as they arrive and advances the instance's clock;
+//the instance runs the processes the policy picks, blocks them on their IO bursts and completes
+//them, exactly as the simulator's slice loop would. Instances share nothing, so different
+//instances can be used from different threads at once; one instance is used by one thread at a
+//time. The instance allocates its tables and its policy's ready queues for max_processes up front,
+//so adding processes and advancing allocate nothing.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//the library exports only what is declared here
+#ifdef __GNUC__
+#define SCHEDULER_API __attribute__((visibility("default")))
+#else
+#define SCHEDULER_API
+#endif
+
+//the policies, numbered as in the simulator's menu
+enum scheduler_policy
+{
+    SCHEDULER_ROUND_ROBIN = 1,
+    SCHEDULER_SHORTEST_PROCESS_NEXT = 2,
+    SCHEDULER_SHORTEST_REMAINING_TIME = 3,
+    SCHEDULER_HIGHEST_RESPONSE_RATIO_NEXT = 4,
+    SCHEDULER_MODIFIED_HRRN = 5,
+    SCHEDULER_FIFO = 6,
+    SCHEDULER_MULTILEVEL_QUEUE = 7,
+    SCHEDULER_MULTILEVEL_FEEDBACK_QUEUE = 8,
+    SCHEDULER_EARLIEST_DEADLINE_FIRST = 9,
+    SCHEDULER_NON_PREEMPTIVE_EDF = 10,
+    SCHEDULER_LEAST_LAXITY_FIRST = 11
+};
+
+//errors, returned as negative values
+enum scheduler_error
+{
+    SCHEDULER_ERROR_INVALID = -2,   //an argument is out of range
+    SCHEDULER_ERROR_FULL = -3,      //the instance already has max_processes processes
+    SCHEDULER_ERROR_NO_MEMORY = -4  //a ready queue couldn't grow
+};
+
+//scheduler_next() with nothing to run
+#define SCHEDULER_IDLE -1
+
+//time used for "never"
+#define SCHEDULER_NEVER 2147483647
+
+typedef struct scheduler_params
+{
+    int quantum;        //round robin and multilevel queue quantum, > 0
+    int high_quantum;   //multilevel feedback queue: time to demotion and to promotion
+    int low_quantum;
+    int max_processes;  //processes the instance can hold, > 0
+    int max_bursts;     //most bursts a process can have, 0 for single CPU bursts only
+} scheduler_params;
+
+typedef struct scheduler_process
+{
+    int start_time;     //time it arrives, >= 0
+    int cpu_time;       //time it needs, > 0; ignored with bursts
+    int priority;       //0-9: 0-4 foreground, 5-9 background
+    int deadline;       //time after its start by which it should complete, 0 for none
+    const int* bursts;  //alternating CPU and IO bursts, first and last CPU, or NULL
+    int num_bursts;
+} scheduler_process;
+
+typedef struct scheduler_instance scheduler_instance;
+
+//Creates an instance of policy. Returns NULL if an argument is out of range or memory runs out.
+SCHEDULER_API scheduler_instance* scheduler_create(int policy, const scheduler_params* params);
+
+SCHEDULER_API void scheduler_destroy(scheduler_instance* s);
+
+//Adds process p and returns its number (0 for the first added, and so on) or an error. Each
+//process is added before the instance advances past its start. One that is due by the time it
+//is added after scheduler_next() decided the current step waits for the next step's decision.
+SCHEDULER_API int scheduler_add_process(scheduler_instance* s, const scheduler_process* p);
+
+//Runs the schedule up to time. Every process arriving before time must have been added.
+//Returns the number of processes completed so far, or an error.
+SCHEDULER_API int scheduler_advance(scheduler_instance* s, int time);
+
+//scheduler_advance() by one time step
+SCHEDULER_API int scheduler_tick(scheduler_instance* s);
+
+//The process that runs at the current time, SCHEDULER_IDLE if none. If until isn't NULL it
+//gets the time the decision holds to, unless a process arrives sooner (SCHEDULER_NEVER if idle with
+//nothing to come). Returns an error if a ready queue couldn't grow.
+SCHEDULER_API int scheduler_next(scheduler_instance* s, int* until);
+
+//the current time
+SCHEDULER_API int scheduler_now(const scheduler_instance* s);
+
+//The last time step process ran in if it has completed, -1 if it hasn't, or an error
+SCHEDULER_API int scheduler_finish_time(const scheduler_instance* s, int process);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
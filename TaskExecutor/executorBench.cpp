@@ -0,0 +1,127 @@
+/*  Task executor benchmark: task throughput and latency per dispatch policy under contention.
+    Usage: executorBench [tasks per submitter] [submitters] [workers]
+*/
+
+#include<iostream>
+#include<iomanip>   // setw
+#include<vector>
+#include<random>    // task mix
+#include<chrono>
+#include<algorithm> // sort
+#include<string>
+#include "taskExecutor.h"
+
+using namespace std::chrono;
+
+//work done by one step of a task
+static const microseconds STEP(10);
+
+//steps of the short and the long tasks, and how many in a hundred are long
+static const int SHORT_STEPS = 5;
+static const int LONG_STEPS = 200;
+static const int LONG_PERCENT = 10;
+
+//fraction of the workers' capacity the submitters offer
+static const double LOAD = 0.9;
+
+static void busyFor(microseconds length)
+{
+    auto end = steady_clock::now() + length;
+    while(steady_clock::now() < end)
+        ;
+}
+
+//nearest rank percentile of sorted values
+static double percentile(const vector<double>& sorted, double pct)
+{
+    if(sorted.empty())
+        return 0;
+    size_t rank = max(static_cast<size_t>(sorted.size() * pct / 100 + 0.999999), static_cast<size_t>(1));
+    return sorted[min(rank, sorted.size()) - 1];
+}
+
+int main(int argc, char* argv[])
+{
+    int tasksPerSubmitter = argc > 1 ? stoi(argv[1]) : 500;
+    int submitters = argc > 2 ? stoi(argv[2]) : 4;
+    int workers = argc > 3 ? stoi(argv[3]) : max(1u, thread::hardware_concurrency());
+    int total = tasksPerSubmitter * submitters;
+
+    //each submitter paces its tasks so that together they offer LOAD of the workers' capacity
+    double meanSteps = (SHORT_STEPS * (100 - LONG_PERCENT) + LONG_STEPS * LONG_PERCENT) / 100.0;
+    microseconds gap(static_cast<long long>(meanSteps * STEP.count() * submitters / (LOAD * workers)));
+
+    struct Named { DispatchPolicy policy; const char* name; };
+    const Named policies[] = {{DispatchPolicy::FIFO, "FIFO"}, {DispatchPolicy::ROUND_ROBIN, "Round Robin"},
+                              {DispatchPolicy::SHORTEST_REMAINING, "Shortest Remaining"},
+                              {DispatchPolicy::MULTILEVEL_FEEDBACK, "Multilevel Feedback"}};
+
+    cout << total << " tasks from " << submitters << " submitters on " << workers << " workers, "
+         << LONG_PERCENT << "% long (" << LONG_STEPS * STEP.count() << " us), the rest short ("
+         << SHORT_STEPS * STEP.count() << " us), offered load " << LOAD << "\n"
+         << "Latencies in us\n\n"
+         << "             Policy |    Tasks/s |     Mean |      p50 |      p99 |      Max | Short p99 |   Steals | Switches |\n"
+         << string(113, '-') << "\n" << setprecision(0) << fixed;
+
+    for(auto& named: policies)
+    {
+        vector<double> latency(total), shortLatency;
+        vector<char> isLong(total);
+        steady_clock::time_point begin, end;
+        long long steals, switches;
+        {
+            TaskExecutor executor(named.policy, workers, 100);
+            vector<thread> threads;
+            begin = steady_clock::now();
+            for(int s = 0; s < submitters; ++s)
+                threads.emplace_back([&, s]()
+                {
+                    mt19937 random(s + 1);
+                    auto next = steady_clock::now();
+                    for(int i = 0; i < tasksPerSubmitter; ++i)
+                    {
+                        int id = s * tasksPerSubmitter + i;
+                        isLong[id] = static_cast<int>(random() % 100) < LONG_PERCENT;
+                        int steps = isLong[id] ? LONG_STEPS : SHORT_STEPS;
+                        TaskOptions options;
+                        options.costHintUs = steps * STEP.count();
+                        options.priority = isLong[id] ? 7 : random() % 5;
+                        auto submitted = steady_clock::now();
+                        auto left = make_shared<int>(steps);
+                        executor.submit([&latency, id, submitted, left]()
+                        {
+                            busyFor(STEP);
+                            if(--*left > 0)
+                                return true;
+                            latency[id] = duration_cast<nanoseconds>(steady_clock::now() - submitted).count() / 1000.0;
+                            return false;
+                        }, options);
+                        next += gap;
+                        this_thread::sleep_until(next);
+                    }
+                });
+            for(auto& t: threads)
+                t.join();
+            executor.wait();
+            end = steady_clock::now();
+            steals = executor.steals();
+            switches = executor.switches();
+        }
+
+        double sum = 0;
+        for(int i = 0; i < total; ++i)
+        {
+            sum += latency[i];
+            if(!isLong[i])
+                shortLatency.push_back(latency[i]);
+        }
+        sort(latency.begin(), latency.end());
+        sort(shortLatency.begin(), shortLatency.end());
+        double seconds = duration_cast<microseconds>(end - begin).count() / 1e6;
+        cout << setw(19) << named.name << " |" << setw(11) << total / seconds << " |" << setw(9) << sum / max(total, 1) << " |"
+             << setw(9) << percentile(latency, 50) << " |" << setw(9) << percentile(latency, 99) << " |"
+             << setw(9) << percentile(latency, 100) << " |" << setw(10) << percentile(shortLatency, 99) << " |"
+             << setw(9) << steals << " |" << setw(9) << switches << " |" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#ifndef MULTIQUEUE_H
+#define MULTIQUEUE_H
+
+#include<atomic>
+#include<vector>
+#include<memory>     // unique_ptr
+#include<climits>    // LLONG_MAX
+#include<algorithm>  // push_heap, pop_heap
+#include<cstdint>
+
+using namespace std;
+
+//MultiQueue observer that does nothing
+struct NoQueueObserver
+{
+    void operator()(long long, bool) const {}
+};
+
+//Relaxed concurrent priority queue, smallest key first (a MultiQueue). The items are spread over
+//several binary heaps, each behind a lock of its own that is only ever tried, never waited on.
+//A push goes to a random heap; a pop looks at the cached smallest keys of two random heaps and
+//takes from the better one. A busy heap just means another random pick, so no thread waits on
+//another and there is no global lock. The price is that a pop can return an item other than the
+//smallest; the rank error stays around the number of heaps on average (see pqBench.cpp).
+//observer(key, popped) is called for every push and pop while its heap is locked, so the calls
+//are in an order the operations could have happened in.
+template<class T, class Observer = NoQueueObserver>
+class MultiQueue
+{
+public:
+    //key of an empty heap
+    static constexpr long long EMPTY = LLONG_MAX;
+
+    explicit MultiQueue(int numHeaps, Observer observer = Observer()) : heaps(max(numHeaps, 2)), observer(observer)
+    {
+        for(auto& h: heaps)
+            h.reset(new Heap);
+    }
+
+    void push(long long key, const T& value)
+    {
+        while(true)
+        {
+            Heap& h = *heaps[pick()];
+            if(!h.tryLock())
+                continue;
+            h.items.emplace_back(key, value);
+            push_heap(h.items.begin(), h.items.end(), keyAfter);
+            h.top.store(h.items.front().first, memory_order_relaxed);
+            observer(key, false);
+            h.unlock();
+            return;
+        }
+    }
+
+    //Takes an item with a small key. Returns false if every heap was empty when looked at.
+    bool tryPop(long long& key, T& value)
+    {
+        while(true)
+        {
+            //a few random pairs, then every heap in turn before calling the queue empty
+            for(int attempt = 0; attempt < 8; ++attempt)
+            {
+                size_t i = pick(), j = pick();
+                Heap& h = heaps[j]->top.load(memory_order_relaxed) < heaps[i]->top.load(memory_order_relaxed) ? *heaps[j] : *heaps[i];
+                if(h.top.load(memory_order_relaxed) != EMPTY && h.tryLock())
+                {
+                    bool taken = popLocked(h, key, value);
+                    h.unlock();
+                    if(taken)
+                        return true;
+                }
+            }
+            bool allEmpty = true;
+            for(auto& h: heaps)
+                if(h->top.load(memory_order_relaxed) != EMPTY)
+                {
+                    allEmpty = false;
+                    if(h->tryLock())
+                    {
+                        bool taken = popLocked(*h, key, value);
+                        h->unlock();
+                        if(taken)
+                            return true;
+                    }
+                }
+            if(allEmpty)
+                return false;
+        }
+    }
+
+    //The smaller cached key of two random heaps, EMPTY if both are empty. A cheap guess at the
+    //smallest key queued, for deciding whether to give way to a shorter item.
+    long long sampleKey() const
+    {
+        return min(heaps[pick()]->top.load(memory_order_relaxed), heaps[pick()]->top.load(memory_order_relaxed));
+    }
+
+private:
+    struct alignas(64) Heap
+    {
+        atomic<bool> locked{false};
+        atomic<long long> top{EMPTY};      //smallest key, read without the lock
+        vector<pair<long long, T>> items;  //min heap on the key
+
+        bool tryLock() { return !locked.load(memory_order_relaxed) && !locked.exchange(true, memory_order_acquire); }
+        void unlock() { locked.store(false, memory_order_release); }
+    };
+
+    //heap order on the key alone
+    static bool keyAfter(const pair<long long, T>& a, const pair<long long, T>& b) { return a.first > b.first; }
+
+    bool popLocked(Heap& h, long long& key, T& value)
+    {
+        if(h.items.empty())
+            return false;
+        pop_heap(h.items.begin(), h.items.end(), keyAfter);
+        key = h.items.back().first;
+        value = h.items.back().second;
+        h.items.pop_back();
+        h.top.store(h.items.empty() ? EMPTY : h.items.front().first, memory_order_relaxed);
+        observer(key, true);
+        return true;
+    }
+
+    //a random heap, from a generator of the calling thread's own
+    size_t pick() const
+    {
+        static thread_local uint64_t state = 0x9E3779B97F4A7C15ULL ^ reinterpret_cast<uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state % heaps.size();
+    }
+
+    vector<unique_ptr<Heap>> heaps;
+    Observer observer;
+};
+
+#endif
@@ -0,0 +1,185 @@
+/*  MultiQueue benchmark: throughput and rank error across thread counts, against one heap behind
+    a global lock.
+    Usage: pqBench [operations per thread] [max threads]
+*/
+
+#include<iostream>
+#include<iomanip>   // setw
+#include<vector>
+#include<queue>     // priority_queue
+#include<mutex>
+#include<thread>
+#include<random>
+#include<chrono>
+#include<algorithm> // sort
+#include<functional> // greater
+#include "multiQueue.h"
+
+using namespace std::chrono;
+
+//keys are drawn from [0, KEY_RANGE), and the queue starts with PREFILL of them
+static const int KEY_RANGE = 1 << 20;
+static const int PREFILL = 1 << 16;
+
+//one heap behind one lock, the baseline
+class LockedHeap
+{
+public:
+    void push(long long key, int value)
+    {
+        lock_guard<mutex> lock(m);
+        heap.push(make_pair(key, value));
+    }
+
+    bool tryPop(long long& key, int& value)
+    {
+        lock_guard<mutex> lock(m);
+        if(heap.empty())
+            return false;
+        key = heap.top().first;
+        value = heap.top().second;
+        heap.pop();
+        return true;
+    }
+
+private:
+    mutex m;
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> heap;
+};
+
+//an operation as the rank error run logs it, in the order given by ticket
+struct LoggedOp
+{
+    long long ticket;
+    int key;
+    bool pop;
+};
+
+//the log of the thread running, set as it starts
+static thread_local vector<LoggedOp>* threadLog = nullptr;
+
+//MultiQueue observer logging every operation with a ticket taken under the heap's lock
+struct TicketLog
+{
+    atomic<long long>* ticket;
+
+    void operator()(long long key, bool pop) const
+    {
+        if(threadLog)
+            threadLog->push_back(LoggedOp{ticket->fetch_add(1), static_cast<int>(key), pop});
+    }
+};
+
+//Runs threads doing operations each, alternately pushing a random key and popping, on queue.
+//Returns the operations per microsecond. Each thread's operations go to its entry of log if the
+//queue logs them.
+template<class Queue>
+static double run(Queue& queue, int threads, int operations, vector<vector<LoggedOp>>* log)
+{
+    mt19937 prefill(12345);
+    for(int i = 0; i < PREFILL; ++i)
+        queue.push(prefill() % KEY_RANGE, i);
+    vector<thread> pool;
+    auto start = steady_clock::now();
+    for(int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t]()
+        {
+            mt19937 random(t + 1);
+            if(log)
+                threadLog = &(*log)[t];
+            long long key;
+            int value;
+            for(int i = 0; i < operations; ++i)
+            {
+                bool pop = i % 2 == 1;
+                if(pop)
+                    queue.tryPop(key, value);
+                else
+                    queue.push(random() % KEY_RANGE, i);
+            }
+        });
+    for(auto& t: pool)
+        t.join();
+    long long elapsedUs = duration_cast<microseconds>(steady_clock::now() - start).count();
+    return static_cast<double>(threads) * operations / max(elapsedUs, 1LL);
+}
+
+//Replays the logged operations in ticket order over a count of the keys queued, giving each pop's
+//rank error: how many queued keys were smaller than the one it took.
+static void rankErrors(vector<vector<LoggedOp>>& log, double& mean, long long& worst)
+{
+    vector<LoggedOp> ops;
+    for(auto& l: log)
+        ops.insert(ops.end(), l.begin(), l.end());
+    sort(ops.begin(), ops.end(), [](const LoggedOp& a, const LoggedOp& b) { return a.ticket < b.ticket; });
+
+    //Fenwick tree of key counts
+    vector<long long> tree(KEY_RANGE + 1, 0);
+    auto add = [&](int key, int delta)
+    {
+        for(int i = key + 1; i <= KEY_RANGE; i += i & -i)
+            tree[i] += delta;
+    };
+    auto countBelow = [&](int key)
+    {
+        long long count = 0;
+        for(int i = key; i > 0; i -= i & -i)
+            count += tree[i];
+        return count;
+    };
+    mt19937 prefill(12345);
+    for(int i = 0; i < PREFILL; ++i)
+        add(prefill() % KEY_RANGE, 1);
+
+    long long total = 0, pops = 0;
+    worst = 0;
+    for(auto& op: ops)
+    {
+        if(!op.pop)
+        {
+            add(op.key, 1);
+            continue;
+        }
+        long long rank = max(countBelow(op.key), 0LL);
+        total += rank;
+        worst = max(worst, rank);
+        ++pops;
+        add(op.key, -1);
+    }
+    mean = static_cast<double>(total) / max(pops, 1LL);
+}
+
+int main(int argc, char* argv[])
+{
+    int operations = argc > 1 ? stoi(argv[1]) : 1000000;
+    int maxThreads = argc > 2 ? stoi(argv[2]) : max(1u, thread::hardware_concurrency());
+
+    cout << operations << " operations per thread, alternating push and pop, on " << PREFILL << " queued keys\n"
+         << "MultiQueue with 2 heaps per thread\n\n"
+         << "Threads | MultiQueue Mops/s | Locked heap Mops/s | Speedup | Mean rank error | Max rank error |\n"
+         << string(97, '-') << "\n" << setprecision(2) << fixed;
+    //powers of two up to maxThreads, and maxThreads itself
+    vector<int> counts;
+    for(int threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+    for(int threads: counts)
+    {
+        MultiQueue<int> relaxed(2 * threads);
+        LockedHeap locked;
+        double relaxedRate = run(relaxed, threads, operations, nullptr);
+        double lockedRate = run(locked, threads, operations, nullptr);
+
+        atomic<long long> ticket(0);
+        MultiQueue<int, TicketLog> logged(2 * threads, TicketLog{&ticket});
+        vector<vector<LoggedOp>> log(threads);
+        run(logged, threads, operations, &log);
+        double meanError;
+        long long worstError;
+        rankErrors(log, meanError, worstError);
+
+        cout << setw(7) << threads << " |" << setw(18) << relaxedRate << " |" << setw(19) << lockedRate << " |"
+             << setw(7) << relaxedRate / lockedRate << "x |" << setw(16) << meanError << " |" << setw(15) << worstError << " |" << endl;
+    }
+    return 0;
+}
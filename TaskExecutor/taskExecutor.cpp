@@ -0,0 +1,285 @@
+#include<chrono>     // slices
+#include<algorithm>  // max
+#include "taskExecutor.h"
+#include "taskQueue.h"
+
+using namespace std::chrono;
+
+//idle rounds a worker yields through before it parks
+static const int SPIN_ROUNDS = 64;
+
+//the executor and worker the current thread runs for, so tasks submitted from a task stay local
+static thread_local const TaskExecutor* currentExecutor = nullptr;
+static thread_local int currentWorker = -1;
+
+struct TaskExecutor::Task
+{
+    TaskStep step;
+    TaskOptions options;
+    long long usedUs;   //time run so far
+    int level;          //level it is queued on
+};
+
+//A worker's levels and counters, on cache lines of their own. The counters are written only by
+//the worker.
+struct alignas(64) TaskExecutor::Worker
+{
+    vector<unique_ptr<TaskRing<Task*>>> levels;
+    thread runner;
+    int slicesSinceBoost = 0;
+    atomic<long long> completed{0};
+    atomic<long long> steals{0};
+    atomic<long long> switches{0};
+};
+
+TaskExecutor::TaskExecutor(DispatchPolicy policy, int numWorkers, int sliceUs)
+    : policy(policy), sliceUs(max(sliceUs, 1)), numLevels(0), nextWorker(0), queued(0), pending(0), sleepers(0), stopping(false)
+{
+    numLevels = levelsFor();
+    if(policy == DispatchPolicy::SHORTEST_REMAINING)
+        shortest.reset(new MultiQueue<Task*>(HEAPS_PER_WORKER * max(numWorkers, 1)));
+    for(int w = 0; w < max(numWorkers, 1); ++w)
+    {
+        pool.emplace_back(new Worker);
+        for(int l = 0; l < numLevels; ++l)
+            pool.back()->levels.emplace_back(new TaskRing<Task*>(QUEUE_SIZE));
+    }
+    //started once every worker's levels exist, since they steal from each other
+    for(size_t w = 0; w < pool.size(); ++w)
+        pool[w]->runner = thread(&TaskExecutor::loop, this, w);
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    wait();
+    {
+        lock_guard<mutex> lock(parkMutex);
+        stopping = true;
+    }
+    parked.notify_all();
+    for(auto& w: pool)
+        w->runner.join();
+}
+
+int TaskExecutor::levelsFor() const
+{
+    switch(policy)
+    {
+        case DispatchPolicy::SHORTEST_REMAINING:
+            return 0;
+        case DispatchPolicy::MULTILEVEL_FEEDBACK:
+            return FEEDBACK_LEVELS;
+        default:
+            return 1;
+    }
+}
+
+int TaskExecutor::initialLevel(const Task& t) const
+{
+    return policy == DispatchPolicy::MULTILEVEL_FEEDBACK && t.options.priority >= 5 ? 1 : 0;
+}
+
+//the task's SHORTEST_REMAINING key: its hint less the time it has run, after every hint if it has none
+long long TaskExecutor::remainingCost(const Task& t) const
+{
+    if(t.options.costHintUs <= 0)
+        return MultiQueue<Task*>::EMPTY - 1;
+    return max(t.options.costHintUs - t.usedUs, 0LL);
+}
+
+void TaskExecutor::submit(TaskStep step, const TaskOptions& options)
+{
+    Task* t = new Task{move(step), options, 0, 0};
+    t->level = initialLevel(*t);
+    pending.fetch_add(1);
+    int w = currentExecutor == this ? currentWorker : nextWorker.fetch_add(1, memory_order_relaxed) % pool.size();
+    enqueue(w, t);
+}
+
+void TaskExecutor::run(function<void()> f, const TaskOptions& options)
+{
+    submit([f]() { f(); return false; }, options);
+}
+
+//Puts t on its level of worker w, or of the next worker with room, waiting for room if all are
+//full, and wakes a parked worker
+void TaskExecutor::enqueue(int w, Task* t)
+{
+    size_t n = pool.size();
+    if(shortest)
+        shortest->push(remainingCost(*t), t);
+    else
+        for(size_t i = 0; !pool[(w + i) % n]->levels[t->level]->tryPush(t); ++i)
+            if(i % n == n - 1)
+                this_thread::yield();
+    queued.fetch_add(1);
+    if(sleepers.load() > 0)
+    {
+        lock_guard<mutex> lock(parkMutex);
+        parked.notify_one();
+    }
+}
+
+//the next task for worker w: from its own levels in order, else stolen from another's; under
+//SHORTEST_REMAINING, whatever the MultiQueue gives
+TaskExecutor::Task* TaskExecutor::take(int w)
+{
+    Task* t;
+    long long key;
+    if(shortest)
+    {
+        if(!shortest->tryPop(key, t))
+            return nullptr;
+        queued.fetch_sub(1);
+        return t;
+    }
+    Worker& self = *pool[w];
+    for(int l = 0; l < numLevels; ++l)
+        if(self.levels[l]->tryPop(t))
+        {
+            queued.fetch_sub(1);
+            return t;
+        }
+    for(size_t i = 1; i < pool.size(); ++i)
+    {
+        Worker& victim = *pool[(w + i) % pool.size()];
+        for(int l = 0; l < numLevels; ++l)
+            if(victim.levels[l]->tryPop(t))
+            {
+                queued.fetch_sub(1);
+                self.steals.fetch_add(1, memory_order_relaxed);
+                return t;
+            }
+    }
+    return nullptr;
+}
+
+//Runs t on worker w until it completes or the policy switches it out, then puts it back. When
+//there is no room to put it back it carries on, since a worker waiting for room in its own
+//levels could wait forever.
+void TaskExecutor::runTask(int w, Task* t)
+{
+    Worker& self = *pool[w];
+    bool slicing = policy == DispatchPolicy::ROUND_ROBIN || policy == DispatchPolicy::MULTILEVEL_FEEDBACK;
+    while(true)
+    {
+        long long slice = static_cast<long long>(sliceUs) << (policy == DispatchPolicy::MULTILEVEL_FEEDBACK ? t->level : 0);
+        auto start = steady_clock::now();
+        bool more, usedSlice = false;
+        while((more = t->step()))
+        {
+            if(slicing && duration_cast<microseconds>(steady_clock::now() - start).count() >= slice)
+            {
+                usedSlice = true;
+                break;
+            }
+            //a shorter task waiting preempts
+            if(shortest && shortest->sampleKey() < remainingCost(*t) - duration_cast<microseconds>(steady_clock::now() - start).count())
+                break;
+        }
+        t->usedUs += duration_cast<microseconds>(steady_clock::now() - start).count();
+
+        if(!more)
+        {
+            delete t;
+            self.completed.fetch_add(1, memory_order_relaxed);
+            if(pending.fetch_sub(1) == 1)
+            {
+                lock_guard<mutex> lock(parkMutex);
+                drained.notify_all();
+            }
+            return;
+        }
+        if(policy == DispatchPolicy::MULTILEVEL_FEEDBACK && usedSlice && t->level < FEEDBACK_LEVELS - 1)
+            ++t->level;
+        if(shortest)
+            shortest->push(remainingCost(*t), t);
+        if(shortest || self.levels[t->level]->tryPush(t))
+        {
+            queued.fetch_add(1);
+            self.switches.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+//moves worker w's tasks on the lower levels back to level 0
+void TaskExecutor::boost(int w)
+{
+    Worker& self = *pool[w];
+    self.slicesSinceBoost = 0;
+    Task* t;
+    for(int l = 1; l < numLevels; ++l)
+        for(size_t moved = 0; moved < QUEUE_SIZE && self.levels[l]->tryPop(t); ++moved)
+        {
+            t->level = 0;
+            if(!self.levels[0]->tryPush(t))
+            {
+                queued.fetch_sub(1);
+                runTask(w, t);
+            }
+        }
+}
+
+void TaskExecutor::loop(int w)
+{
+    currentExecutor = this;
+    currentWorker = w;
+    int idle = 0;
+    while(true)
+    {
+        Task* t = take(w);
+        if(t)
+        {
+            idle = 0;
+            runTask(w, t);
+            if(policy == DispatchPolicy::MULTILEVEL_FEEDBACK && ++pool[w]->slicesSinceBoost >= BOOST_SLICES)
+                boost(w);
+            continue;
+        }
+        if(++idle < SPIN_ROUNDS)
+        {
+            this_thread::yield();
+            continue;
+        }
+        idle = 0;
+        //parks until work is queued; enqueue() checks sleepers after counting the task, so one
+        //of the two sees the other
+        unique_lock<mutex> lock(parkMutex);
+        sleepers.fetch_add(1);
+        parked.wait(lock, [this]() { return queued.load() > 0 || stopping; });
+        sleepers.fetch_sub(1);
+        if(stopping && queued.load() == 0)
+            return;
+    }
+}
+
+void TaskExecutor::wait()
+{
+    unique_lock<mutex> lock(parkMutex);
+    drained.wait(lock, [this]() { return pending.load() == 0; });
+}
+
+long long TaskExecutor::completed() const
+{
+    long long total = 0;
+    for(auto& w: pool)
+        total += w->completed.load(memory_order_relaxed);
+    return total;
+}
+
+long long TaskExecutor::steals() const
+{
+    long long total = 0;
+    for(auto& w: pool)
+        total += w->steals.load(memory_order_relaxed);
+    return total;
+}
+
+long long TaskExecutor::switches() const
+{
+    long long total = 0;
+    for(auto& w: pool)
+        total += w->switches.load(memory_order_relaxed);
+    return total;
+}
@@ -0,0 +1,109 @@
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include<functional>
+#include<thread>
+#include<atomic>
+#include<mutex>
+#include<condition_variable>
+#include<vector>
+#include<memory>  // unique_ptr
+#include "multiQueue.h"
+
+using namespace std;
+
+//How each worker orders its ready tasks, after the simulator's policies of the same names
+enum class DispatchPolicy
+{
+    FIFO,                //in submission order, each run to completion
+    ROUND_ROBIN,         //in turn, a slice at a time
+    SHORTEST_REMAINING,  //least remaining cost first, by the tasks' cost hints
+    MULTILEVEL_FEEDBACK  //foreground before background, demoting tasks that use up their slices
+};
+
+//What the submitter knows about a task
+struct TaskOptions
+{
+    int costHintUs = 0;  //expected run time in microseconds for SHORTEST_REMAINING, 0 if unknown
+    int priority = 0;    //0-4 foreground, 5-9 background, as Process::priority, for MULTILEVEL_FEEDBACK
+};
+
+//A task's body, run a step at a time: each call does some work and returns true while there is
+//more to do. The slicing policies only switch tasks between steps, so a task that never returns
+//true runs to completion under every policy.
+typedef function<bool()> TaskStep;
+
+//Thread pool whose workers each keep their ready tasks in a few levels, each a lock-free ring
+//(see taskQueue.h), and always run from the first non-empty level. The policy decides the level:
+//  FIFO and ROUND_ROBIN use one level; ROUND_ROBIN puts a task back at its tail after a slice.
+//  SHORTEST_REMAINING instead keeps every worker's tasks in one MultiQueue (see multiQueue.h)
+//  keyed by remaining cost, the hint less the time the task has run, unknown costs last. Each
+//  worker takes a task with about the smallest key and switches at a step when a sampled key is
+//  smaller than its task's, with no global lock and nothing to steal.
+//  MULTILEVEL_FEEDBACK starts foreground tasks on level 0 and background ones on level 1. A task
+//  that runs its whole slice (which doubles per level) drops a level, and every BOOST_SLICES
+//  slices each worker moves its lower levels back to level 0, so nothing starves.
+//Tasks submitted from a worker go to its own levels, the others to the workers in turn. A
+//worker that runs out of tasks steals from the others' levels, lock-free like its own, then
+//spins a little and parks until more work is submitted.
+class TaskExecutor
+{
+public:
+    static const size_t QUEUE_SIZE = 1 << 12;    //tasks one level of one worker holds
+    static const int HEAPS_PER_WORKER = 2;       //SHORTEST_REMAINING MultiQueue heaps
+    static const int FEEDBACK_LEVELS = 3;        //MULTILEVEL_FEEDBACK levels
+    static const int BOOST_SLICES = 64;
+
+    //numWorkers threads; sliceUs is the slice of ROUND_ROBIN and of MULTILEVEL_FEEDBACK's level 0
+    TaskExecutor(DispatchPolicy policy, int numWorkers = thread::hardware_concurrency(), int sliceUs = 1000);
+
+    //waits for the submitted tasks, then stops the workers
+    ~TaskExecutor();
+
+    //queues a task, waiting for room if every worker's level is full
+    void submit(TaskStep step, const TaskOptions& options = TaskOptions());
+
+    //queues f as a task of one step
+    void run(function<void()> f, const TaskOptions& options = TaskOptions());
+
+    //waits until every task submitted so far has completed; not for calling from a task
+    void wait();
+
+    int workers() const { return pool.size(); }
+
+    //totals over the workers: tasks completed, tasks taken from another worker, and times a
+    //task was switched out before it completed
+    long long completed() const;
+    long long steals() const;
+    long long switches() const;
+
+private:
+    struct Task;
+    struct Worker;
+
+    int levelsFor() const;
+    int initialLevel(const Task& t) const;
+    long long remainingCost(const Task& t) const;
+    void enqueue(int worker, Task* t);
+    Task* take(int worker);
+    void runTask(int worker, Task* t);
+    void boost(int worker);
+    void loop(int worker);
+
+    DispatchPolicy policy;
+    int sliceUs;
+    int numLevels;
+    vector<unique_ptr<Worker>> pool;
+    unique_ptr<MultiQueue<Task*>> shortest;   //the SHORTEST_REMAINING ready tasks
+    atomic<unsigned int> nextWorker;   //where the next task from outside goes
+    atomic<long long> queued;          //tasks sitting in a level
+    atomic<long long> pending;         //tasks submitted and not completed
+
+    mutex parkMutex;                   //guards parking only, never the queues
+    condition_variable parked;         //work was queued or the executor is stopping
+    condition_variable drained;        //pending reached 0
+    atomic<int> sleepers;
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef TASKQUEUE_H
+#define TASKQUEUE_H
+
+#include<atomic>
+#include<memory>   // unique_ptr
+#include<cstddef>  // size_t
+
+using namespace std;
+
+//Bounded lock-free multi-producer multi-consumer ring. Each slot carries a sequence number that
+//says whose turn it is: a producer claims the slot at the tail with one compare and swap when its
+//sequence equals the tail position and bumps it once the item is in; a consumer claims the slot
+//at the head the same way once its sequence is one past the head position, and hands it back to
+//the producers a lap later. The owner of a queue and the workers stealing from it are all just
+//consumers. The capacity is rounded up to a power of two.
+template<class T>
+class TaskRing
+{
+public:
+    explicit TaskRing(size_t capacity) : mask(roundUp(capacity) - 1), slots(new Slot[mask + 1]), tail(0), head(0)
+    {
+        for(size_t i = 0; i <= mask; ++i)
+            slots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    //adds item at the tail, returning false if the ring is full
+    bool tryPush(const T& item)
+    {
+        size_t pos = tail.load(memory_order_relaxed);
+        while(true)
+        {
+            Slot& slot = slots[pos & mask];
+            long long turn = static_cast<long long>(slot.sequence.load(memory_order_acquire) - pos);
+            if(turn == 0)
+            {
+                if(tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if(turn < 0)
+                return false;
+            else
+                pos = tail.load(memory_order_relaxed);
+        }
+    }
+
+    //takes the item at the head, returning false if the ring is empty
+    bool tryPop(T& item)
+    {
+        size_t pos = head.load(memory_order_relaxed);
+        while(true)
+        {
+            Slot& slot = slots[pos & mask];
+            long long turn = static_cast<long long>(slot.sequence.load(memory_order_acquire) - (pos + 1));
+            if(turn == 0)
+            {
+                if(head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    item = slot.item;
+                    slot.sequence.store(pos + mask + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if(turn < 0)
+                return false;
+            else
+                pos = head.load(memory_order_relaxed);
+        }
+    }
+
+    //whether the ring looked empty; only a hint, since it can change right after
+    bool empty() const
+    {
+        return head.load(memory_order_relaxed) >= tail.load(memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        atomic<size_t> sequence;
+        T item;
+    };
+
+    static size_t roundUp(size_t n)
+    {
+        size_t size = 1;
+        while(size < n)
+            size <<= 1;
+        return size;
+    }
+
+    size_t mask;
+    unique_ptr<Slot[]> slots;
+    //producers and consumers each keep their position on a cache line of their own
+    alignas(64) atomic<size_t> tail;
+    alignas(64) atomic<size_t> head;
+};
+
+#endif
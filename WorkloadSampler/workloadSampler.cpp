@@ -0,0 +1,263 @@
+/*  Workload down-sampler: streams a process list once and writes a much smaller one with the same
+    arrival rate, arrival pattern, CPU demand and priority mix, for quick what-if iterations.
+    Usage: workloadSampler <process list> <output file> <fraction> [seed]
+
+    The processes are stratified by arrival window, CPU demand (by power of two) and priority, and
+    each stratum keeps a uniform sample of its share (fraction of its processes, rounded at random
+    so small strata are represented on average). A stratum samples with a bottom-k reservoir: each
+    process gets a random key and the stratum keeps those under twice the fraction plus the
+    MIN_KEEP smallest, so memory stays proportional to the sample and the final pick of the
+    smallest keys is a uniform sample however many processes the stratum ends up with. The
+    arrival windows start narrow and double whenever there are more than MAX_WINDOWS of them,
+    merging their strata, so the trace's time span needn't be known up front.
+
+    Taking a fraction of the processes would thin the arrivals out by that fraction, so the
+    sampled start times are scaled by it too: the sample arrives at the original rate, over a
+    fraction of the time. The report compares the sample with the original: arrival rate, the
+    Kolmogorov-Smirnov distance of the arrival times (over the windows) and the CPU demand (over
+    log-linear buckets), and the priority mix.
+*/
+
+#include<iostream>
+#include<fstream>
+#include<sstream>
+#include<iomanip>   // setprecision
+#include<random>
+#include<map>
+#include<tuple>
+#include<cmath>     // floor
+#include "../stats.h"
+
+//arrival windows kept before they are doubled in width
+static const size_t MAX_WINDOWS = 64;
+
+//processes a stratum keeps whatever their keys
+static const size_t MIN_KEEP = 8;
+
+//a process as the reservoirs keep it: the text of its line around the start time
+struct Candidate
+{
+    double key;
+    long long order;    //line number in the input
+    int start;
+    string name;
+    string tail;        //the columns after the start time, as given
+};
+
+static bool keyBefore(const Candidate& a, const Candidate& b) { return a.key < b.key; }
+
+//the processes of one stratum seen so far and the ones kept from them, a max heap on the key
+struct Stratum
+{
+    long long seen = 0;
+    vector<Candidate> kept;
+
+    //keeps every candidate under threshold and the MIN_KEEP smallest
+    void trim(double threshold)
+    {
+        while(kept.size() > MIN_KEEP && kept.front().key >= threshold)
+        {
+            pop_heap(kept.begin(), kept.end(), keyBefore);
+            kept.pop_back();
+        }
+    }
+
+    void offer(Candidate&& c, double threshold)
+    {
+        ++seen;
+        if(c.key >= threshold && kept.size() >= MIN_KEEP && c.key >= kept.front().key)
+            return;
+        kept.push_back(move(c));
+        push_heap(kept.begin(), kept.end(), keyBefore);
+        trim(threshold);
+    }
+
+    void merge(Stratum& other, double threshold)
+    {
+        seen += other.seen;
+        for(auto& c: other.kept)
+            kept.push_back(move(c));
+        make_heap(kept.begin(), kept.end(), keyBefore);
+        trim(threshold);
+    }
+};
+
+typedef tuple<long long, int, int> StratumKey;  //arrival window, CPU demand class, priority
+
+//what the distributions are compared on
+struct Distributions
+{
+    long long count = 0;
+    long long cpu[HISTOGRAM_BUCKETS] = {};
+    long long priorities[10] = {};
+    map<long long, long long> windows;     //arrivals per window
+    double cpuSum = 0;
+    long long firstStart = INT_MAX, lastStart = 0;
+
+    void add(int start, int total, int priority, int shift)
+    {
+        ++count;
+        ++cpu[histogramBucket(total)];
+        ++priorities[min(max(priority, 0), 9)];
+        ++windows[max(start, 0) >> shift];
+        cpuSum += total;
+        firstStart = min<long long>(firstStart, start);
+        lastStart = max<long long>(lastStart, start);
+    }
+
+    //arrivals per time step
+    double rate() const { return count ? count / static_cast<double>(lastStart - firstStart + 1) : 0; }
+};
+
+//largest difference between the cumulative distributions of two histograms
+template<class Counts>
+static double ksDistance(const Counts& a, long long totalA, const Counts& b, long long totalB, size_t n)
+{
+    double cumA = 0, cumB = 0, worst = 0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        cumA += static_cast<double>(a[i]) / max(totalA, 1LL);
+        cumB += static_cast<double>(b[i]) / max(totalB, 1LL);
+        worst = max(worst, fabs(cumA - cumB));
+    }
+    return worst;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 4)
+    {
+        cerr << "Usage: workloadSampler <process list> <output file> <fraction> [seed]" << endl;
+        return -1;
+    }
+    double fraction = atof(argv[3]);
+    if(!(fraction > 0 && fraction <= 1))
+    {
+        cerr << "The fraction must be in (0, 1]" << endl;
+        return -1;
+    }
+    ifstream in(argv[1]);
+    if(in.fail())
+    {
+        cerr << "Unable to open file \"" << argv[1] << "\"" << endl;
+        return -1;
+    }
+    mt19937_64 random(argc > 4 ? atoll(argv[4]) : 1);
+    uniform_real_distribution<double> unit(0, 1);
+    double threshold = min(2 * fraction, 1.0);
+
+    //one pass over the input
+    int shift = 0;
+    map<StratumKey, Stratum> strata;
+    Distributions original;
+    string line, name, tail;
+    long long declared = 0;
+    getline(in, line);
+    istringstream(line) >> declared;
+    vector<int> bursts;
+    for(long long order = 0; getline(in, line); ++order)
+    {
+        istringstream fields(line);
+        int start, total, priority, workingSet = 0, deadline = 0, group = 0;
+        if(!(fields >> name >> start))
+            continue;
+        getline(fields, tail);
+        istringstream columns(tail);
+        string rest;
+        if(!(columns >> total >> priority))
+            continue;
+        getline(columns, rest);
+        readBurstColumns(rest, total, workingSet, deadline, group, bursts);
+
+        original.add(start, total, priority, shift);
+        strata[StratumKey(max(start, 0) >> shift, 32 - __builtin_clz(max(total, 1)), priority)]
+            .offer(Candidate{unit(random), order, start, name, tail}, threshold);
+
+        //too many windows: double their width, merging the strata of window pairs
+        if(original.windows.size() > MAX_WINDOWS)
+        {
+            ++shift;
+            map<long long, long long> windows;
+            for(auto& w: original.windows)
+                windows[w.first >> 1] += w.second;
+            original.windows.swap(windows);
+            map<StratumKey, Stratum> merged;
+            for(auto& s: strata)
+                merged[StratumKey(get<0>(s.first) >> 1, get<1>(s.first), get<2>(s.first))].merge(s.second, threshold);
+            strata.swap(merged);
+        }
+    }
+
+    //each stratum's share, rounded at random, from its smallest keys
+    vector<Candidate> sample;
+    long long shortfall = 0;
+    for(auto& s: strata)
+    {
+        double share = fraction * s.second.seen;
+        size_t take = static_cast<size_t>(floor(share)) + (unit(random) < share - floor(share));
+        auto& kept = s.second.kept;
+        sort(kept.begin(), kept.end(), keyBefore);
+        shortfall += take > kept.size() ? take - kept.size() : 0;
+        for(size_t i = 0; i < take && i < kept.size(); ++i)
+            sample.push_back(move(kept[i]));
+    }
+    sort(sample.begin(), sample.end(), [](const Candidate& a, const Candidate& b) { return make_pair(a.start, a.order) < make_pair(b.start, b.order); });
+
+    ofstream out(argv[2]);
+    if(out.fail())
+    {
+        cerr << "Unable to write \"" << argv[2] << "\"" << endl;
+        return -1;
+    }
+    Distributions sampled, scaled;
+    out << sample.size() << "\n";
+    for(const Candidate& c: sample)
+    {
+        int start = static_cast<int>(floor(c.start * fraction));
+        out << c.name << " " << start << c.tail << "\n";
+        istringstream columns(c.tail);
+        int total, priority;
+        columns >> total >> priority;
+        string rest;
+        getline(columns, rest);
+        int workingSet = 0, deadline = 0, group = 0;
+        readBurstColumns(rest, total, workingSet, deadline, group, bursts);
+        sampled.add(c.start, total, priority, shift);
+        scaled.add(start, total, priority, 0);
+    }
+    out.close();
+    if(out.fail())
+    {
+        cerr << "Unable to write \"" << argv[2] << "\"" << endl;
+        return -1;
+    }
+
+    //the windows as aligned histograms
+    vector<long long> originalWindows, sampledWindows;
+    for(auto& w: original.windows)
+    {
+        originalWindows.push_back(w.second);
+        sampledWindows.push_back(sampled.windows.count(w.first) ? sampled.windows[w.first] : 0);
+    }
+    double priorityError = 0;
+    for(int p = 0; p < 10; ++p)
+        priorityError = max(priorityError, fabs(static_cast<double>(original.priorities[p]) / max(original.count, 1LL)
+                                                - static_cast<double>(sampled.priorities[p]) / max(sampled.count, 1LL)));
+    auto relative = [](double a, double b) { return a != 0 ? 100 * fabs(b - a) / a : 0; };
+
+    cout << setprecision(4) << "Sampled " << sample.size() << " of " << original.count << " processes";
+    if(declared != original.count)
+        cout << " (the header says " << declared << ")";
+    cout << " from " << strata.size() << " strata, " << original.windows.size() << " arrival windows of " << (1LL << shift)
+         << " time steps; arrivals compressed " << 1 / fraction << "x\n";
+    if(shortfall > 0)
+        cout << "  " << shortfall << " processes short of the strata's shares\n";
+    cout << "  Arrival rate:        " << original.rate() << " per time step, sample " << scaled.rate()
+         << " (" << relative(original.rate(), scaled.rate()) << "% off)\n"
+         << "  Arrival times:       KS distance " << ksDistance(originalWindows, original.count, sampledWindows, sampled.count, originalWindows.size()) << "\n"
+         << "  CPU demand:          mean " << original.cpuSum / max(original.count, 1LL) << ", sample " << sampled.cpuSum / max(sampled.count, 1LL)
+         << " (" << relative(original.cpuSum / max(original.count, 1LL), sampled.cpuSum / max(sampled.count, 1LL)) << "% off), KS distance "
+         << ksDistance(original.cpu, original.count, sampled.cpu, sampled.count, HISTOGRAM_BUCKETS) << "\n"
+         << "  Priority mix:        largest difference " << 100 * priorityError << " percentage points" << endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+#ifndef ADMISSIONRING_H
+#define ADMISSIONRING_H
+
+#include<atomic>
+#include<memory>   // unique_ptr
+#include<cstddef>  // size_t
+
+using namespace std;
+
+//Bounded lock-free multi-producer single-consumer ring. Each slot carries a sequence number that
+//says whose turn it is: a producer claims the slot at the tail with one compare and swap when its
+//sequence equals the tail position, fills it and bumps the sequence to publish it; the consumer
+//takes the slot at the head once its sequence is one past the head position and hands it back to
+//the producers a lap later. Producers never wait on each other except to retry a lost claim, and
+//the consumer never waits at all. The capacity is rounded up to a power of two.
+template<class T>
+class MpscRing
+{
+public:
+    explicit MpscRing(size_t capacity) : mask(roundUp(capacity) - 1), slots(new Slot[mask + 1]), tail(0), head(0)
+    {
+        for(size_t i = 0; i <= mask; ++i)
+            slots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    //Adds item at the tail, from any thread. Returns false, leaving the ring unchanged, if it is full.
+    bool tryPush(const T& item)
+    {
+        size_t pos = tail.load(memory_order_relaxed);
+        while(true)
+        {
+            Slot& slot = slots[pos & mask];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            long long turn = static_cast<long long>(sequence - pos);
+            if(turn == 0)
+            {
+                if(tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    slot.item = item;
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if(turn < 0)
+                return false;   //the consumer hasn't taken the slot from a lap ago yet
+            else
+                pos = tail.load(memory_order_relaxed);
+        }
+    }
+
+    //Takes the item at the head, from the consumer thread only. Returns false if the ring is empty
+    //or the producer that claimed the head slot hasn't finished filling it.
+    bool tryPop(T& item)
+    {
+        Slot& slot = slots[head & mask];
+        if(slot.sequence.load(memory_order_acquire) != head + 1)
+            return false;
+        item = slot.item;
+        slot.sequence.store(head + mask + 1, memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        atomic<size_t> sequence;
+        T item;
+    };
+
+    static size_t roundUp(size_t n)
+    {
+        size_t size = 1;
+        while(size < n)
+            size <<= 1;
+        return size;
+    }
+
+    size_t mask;
+    unique_ptr<Slot[]> slots;
+    //producers and the consumer each keep their position on a cache line of their own
+    alignas(64) atomic<size_t> tail;
+    alignas(64) size_t head;
+};
+
+#endif
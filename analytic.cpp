@@ -0,0 +1,139 @@
+#include<queue>     // priority_queue
+#include<climits>   // LLONG_MIN
+#include<tuple>
+#include<thread>    // parallel scan
+#include<functional> // greater
+#include "analytic.h"
+#include "simulator.h"
+
+//A step of the finish time scan as the function x -> max(x + add, floor). Composing two steps
+//gives another, so runs of steps can be combined in any grouping.
+struct ScanStep
+{
+    long long add;
+    long long floor;
+
+    ScanStep then(const ScanStep& next) const
+    {
+        return {add + next.add, max(floor + next.add, next.floor)};
+    }
+    long long operator()(long long x) const { return max(x + add, floor); }
+};
+
+//Replaces each step with the time the processor frees up after it, starting free at time 0.
+//Large scans are split into one chunk per thread: each chunk's steps are composed, the chunks'
+//start times follow from those in order, then every chunk is finished from its start time.
+static void scanFinishTimes(vector<ScanStep>& steps, vector<long long>& free)
+{
+    size_t n = steps.size();
+    free.resize(n);
+    size_t numThreads = n < PARALLEL_SCAN_MIN ? 1 : max(1u, thread::hardware_concurrency());
+    size_t chunk = (n + numThreads - 1) / numThreads;
+    auto finish = [&](size_t from, size_t to, long long x)
+    {
+        for(size_t k = from; k < to; ++k)
+            free[k] = x = steps[k](x);
+    };
+    if(numThreads == 1)
+    {
+        finish(0, n, 0);
+        return;
+    }
+
+    vector<ScanStep> composed(numThreads, ScanStep{0, 0});
+    vector<thread> threads;
+    for(size_t t = 0; t < numThreads; ++t)
+        threads.emplace_back([&, t]()
+        {
+            ScanStep c = {0, LLONG_MIN / 2};
+            for(size_t k = t * chunk; k < min(n, (t + 1) * chunk); ++k)
+                c = c.then(steps[k]);
+            composed[t] = c;
+        });
+    for(auto& t: threads)
+        t.join();
+    threads.clear();
+
+    long long x = 0;
+    for(size_t t = 0; t < numThreads; ++t)
+    {
+        long long start = x;
+        threads.emplace_back([&, t, start]() { finish(t * chunk, min(n, (t + 1) * chunk), start); });
+        x = composed[t](x);
+    }
+    for(auto& t: threads)
+        t.join();
+}
+
+//records that p ran to completion, the processor freeing up at free, as chargeRun() does
+static void complete(Process& p, long long free)
+{
+    int length = max(p.totalTimeNeeded, 1);
+    p.timeScheduled += length;
+    p.quantumTime += length;
+    p.isDone = true;
+    p.timeFinished = free - 1;
+}
+
+static int evaluateFifo(vector<Process>& procList, SwitchModel& switches)
+{
+    vector<int> order = arrivalOrder(procList);
+    vector<ScanStep> steps(order.size());
+    for(size_t k = 0; k < order.size(); ++k)
+    {
+        Process& p = procList[order[k]];
+        long long run = switches.dispatch(order[k], p) + max(p.totalTimeNeeded, 1);
+        steps[k] = {run, p.startTime + run};
+    }
+    vector<long long> free;
+    scanFinishTimes(steps, free);
+    for(size_t k = 0; k < order.size(); ++k)
+        complete(procList[order[k]], free[k]);
+    return free.empty() ? 0 : free.back() - 1;
+}
+
+//Follows the scheduler's rule that the first arrival after an idle period runs at once, before
+//the processes arriving with it are compared (see ShortestProcessNextScheduler::admit).
+static int evaluateSpn(vector<Process>& procList, SwitchModel& switches)
+{
+    vector<int> order = arrivalOrder(procList);
+    typedef tuple<int, size_t, int> Entry;   //estimated burst time, arrival position, process index
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready;
+    long long free = 0;
+    size_t arrived = 0;
+    for(size_t done = 0; done < order.size(); ++done)
+    {
+        for(; arrived < order.size() && procList[order[arrived]].startTime <= free; ++arrived)
+            ready.push(Entry(estimatedBurstTime(procList[order[arrived]]), arrived, order[arrived]));
+        int idx;
+        if(ready.empty())
+        {
+            idx = order[arrived++];
+            free = procList[idx].startTime;
+        }
+        else
+        {
+            idx = get<2>(ready.top());
+            ready.pop();
+        }
+        Process& p = procList[idx];
+        free += switches.dispatch(idx, p) + max(p.totalTimeNeeded, 1);
+        complete(p, free);
+    }
+    return order.empty() ? 0 : free - 1;
+}
+
+bool evaluateAnalytic(int schedChoice, vector<Process>& procList, SwitchModel& switches, int& lastTime)
+{
+    if(schedChoice != 2 && schedChoice != 6)
+        return false;
+    //a process with IO has more than one CPU burst in the pool
+    for(auto& p: procList)
+        if(p.extras && burstPool()[p.extras + 1] != END_OF_BURSTS)
+            return false;
+
+    for(auto& p: procList)
+        resetBursts(p);
+    lastTime = schedChoice == 6 ? evaluateFifo(procList, switches) : evaluateSpn(procList, switches);
+    return true;
+}
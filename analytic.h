@@ -0,0 +1,25 @@
+#ifndef ANALYTIC_H
+#define ANALYTIC_H
+
+#include "schedulers.h"
+#include "switchModel.h"
+
+using namespace std;
+
+//workloads at least this large have their FIFO finish times scanned on several threads
+const size_t PARALLEL_SCAN_MIN = 1 << 16;
+
+//Closed form evaluation of the non-preemptive policies, First In First Out (choice 6) and
+//Shortest Process Next (choice 2), for workloads without IO. Without IO each process is
+//dispatched once and runs to completion, so the schedule is just an order: arrival order for
+//FIFO, and for SPN the shortest by estimate of the processes that arrived by the time the processor
+//frees up.
+//The finish times then follow from that order without stepping through time:
+//  finish[k] = max(finish[k - 1], arrival[k]) + switch[k] + cpu[k]
+//which is a prefix scan over (max, +), done in parallel for large FIFO workloads. SPN keeps a
+//heap of the arrived processes, so both are O(N log N) whatever the length of the schedule.
+//Leaves procList, switches and the returned last time exactly as simulate() and simulateSlices()
+//would. Returns false, leaving them untouched, if the policy or the workload doesn't qualify.
+bool evaluateAnalytic(int schedChoice, vector<Process>& procList, SwitchModel& switches, int& lastTime);
+
+#endif
@@ -0,0 +1,270 @@
+#include<cstdio>       // snprintf
+#include<map>          // worker connections, loaded workloads
+#include<deque>        // pending runs
+#include<stdexcept>    // invalid_argument
+#include<unistd.h>     // close, unlink
+#include<poll.h>       // poll
+#include<sys/socket.h> // accept, recv
+#include "distributed.h"
+#include "sockets.h"
+
+//how long a worker keeps trying to reach the coordinator (ms), and how often
+static const int CONNECT_TIMEOUT_MS = 10000;
+static const int CONNECT_RETRY_MS = 100;
+
+//doubles are sent with every digit so the results match a local run
+static string exact(double value)
+{
+    char text[32];
+    snprintf(text, sizeof(text), "%.17g", value);
+    return text;
+}
+
+//splits a message at its tabs
+static vector<string> fields(const string& line)
+{
+    vector<string> parts;
+    size_t begin = 0, tab;
+    while((tab = line.find('\t', begin)) != string::npos)
+    {
+        parts.push_back(line.substr(begin, tab - begin));
+        begin = tab + 1;
+    }
+    parts.push_back(line.substr(begin));
+    return parts;
+}
+
+static string runMessage(size_t i, bool slices, const ExperimentRun& run, const WorkloadSource& source)
+{
+    return "RUN\t" + to_string(i) + "\t" + to_string(slices) + "\t" + to_string(run.policy) + "\t" + to_string(run.quantum) + "\t"
+           + to_string(run.highQuantum) + "\t" + to_string(run.lowQuantum) + "\t" + exact(run.switchCost) + "\t"
+           + exact(run.switchCostPerWorkingSet) + "\t" + to_string(source.generateProcs) + "\t" + to_string(source.seed) + "\t"
+           + source.path + "\n";
+}
+
+static string resultMessage(size_t i, const RunResult& r)
+{
+    return "RESULT\t" + to_string(i) + "\t" + to_string(r.lastTime) + "\t" + exact(r.avgTurnaround) + "\t"
+           + exact(r.avgNormalizedTurnaround) + "\t" + exact(r.avgCpuWait) + "\t" + exact(r.avgIoTime) + "\t"
+           + to_string(r.turnaround90) + "\t" + to_string(r.turnaround99) + "\t" + to_string(r.maxTurnaround) + "\t"
+           + to_string(r.switches) + "\t" + exact(r.switchOverhead) + "\t" + to_string(r.runtimeUs) + "\t"
+           + exact(r.deadlineMissRatio) + "\t" + exact(r.meanTardiness) + "\t" + to_string(r.tardiness90) + "\t"
+           + to_string(r.tardiness99) + "\t" + to_string(r.maxTardiness) + "\n";
+}
+
+//parses a RESULT message into i and r, returning false if it is malformed
+static bool parseResult(const vector<string>& f, size_t& i, RunResult& r)
+{
+    if(f.size() != 18)
+        return false;
+    try
+    {
+        i = stoull(f[1]);
+        r.lastTime = stoi(f[2]);
+        r.avgTurnaround = stod(f[3]);
+        r.avgNormalizedTurnaround = stod(f[4]);
+        r.avgCpuWait = stod(f[5]);
+        r.avgIoTime = stod(f[6]);
+        r.turnaround90 = stoi(f[7]);
+        r.turnaround99 = stoi(f[8]);
+        r.maxTurnaround = stoi(f[9]);
+        r.switches = stoll(f[10]);
+        r.switchOverhead = stod(f[11]);
+        r.runtimeUs = stoll(f[12]);
+        r.deadlineMissRatio = stod(f[13]);
+        r.meanTardiness = stod(f[14]);
+        r.tardiness90 = stoi(f[15]);
+        r.tardiness99 = stoi(f[16]);
+        r.maxTardiness = stoi(f[17]);
+    }
+    catch(const logic_error&)
+    {
+        return false;
+    }
+    return true;
+}
+
+//A worker's connection, as seen by the coordinator
+struct WorkerConnection
+{
+    string buffer;  //received text not yet split into lines
+    long long run;  //run the worker holds, -1 if none
+    bool waiting;   //the worker asked for a run while none was pending
+};
+
+bool coordinateExperiment(const ExperimentSpec& spec, const string& address, string& error)
+{
+    //replicas are decided on as results come in, which the workers' pull model doesn't fit
+    if(spec.maxReplicas > 0)
+    {
+        error = "replicas can't be served to workers";
+        return false;
+    }
+    vector<WorkloadSource> sources = workloadSources(spec);
+    vector<ExperimentRun> runs = expandRuns(spec, sources.size());
+    ResultWriter writer;
+    if(!writer.open(spec, sources, runs, error))
+        return false;
+
+    string socketPath;
+    int listenFd = listenOn(address, nullptr, socketPath, error);
+    if(listenFd < 0)
+        return false;
+
+    deque<size_t> pending;
+    for(size_t i = 0; i < runs.size(); ++i)
+        pending.push_back(i);
+    vector<int> attempts(runs.size(), 0);
+    size_t finished = 0, failed = 0;
+    map<int, WorkerConnection> workers;
+
+    //hands the worker the next pending run, or has it wait for one
+    auto dispatch = [&](int fd, WorkerConnection& w)
+    {
+        w.waiting = pending.empty();
+        if(w.waiting)
+            return;
+        size_t i = pending.front();
+        pending.pop_front();
+        ++attempts[i];
+        w.run = i;
+        sendAll(fd, runMessage(i, spec.slices, runs[i], sources[runs[i].workload]));
+    };
+    //gives up on a worker, putting its run back for another one
+    auto drop = [&](int fd)
+    {
+        WorkerConnection& w = workers[fd];
+        if(w.run >= 0)
+        {
+            if(attempts[w.run] < MAX_RUN_ATTEMPTS)
+                pending.push_front(w.run);
+            else
+            {
+                writer.add(w.run, nullptr);
+                ++finished;
+                ++failed;
+            }
+        }
+        close(fd);
+        workers.erase(fd);
+        for(auto& other: workers)
+            if(other.second.waiting && !pending.empty())
+                dispatch(other.first, other.second);
+    };
+
+    while(finished < runs.size())
+    {
+        vector<pollfd> fds(1, pollfd{listenFd, POLLIN, 0});
+        for(auto& w: workers)
+            fds.push_back(pollfd{w.first, POLLIN, 0});
+        if(poll(fds.data(), fds.size(), -1) < 0)
+            continue;
+
+        if(fds[0].revents & POLLIN)
+        {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if(fd >= 0)
+                workers[fd] = WorkerConnection{"", -1, false};
+        }
+        for(size_t k = 1; k < fds.size(); ++k)
+        {
+            if(!fds[k].revents)
+                continue;
+            int fd = fds[k].fd;
+            char chunk[4096];
+            ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+            if(got <= 0)
+            {
+                drop(fd);
+                continue;
+            }
+            WorkerConnection& w = workers[fd];
+            w.buffer.append(chunk, got);
+            size_t newline;
+            bool valid = true;
+            while(valid && (newline = w.buffer.find('\n')) != string::npos)
+            {
+                vector<string> f = fields(w.buffer.substr(0, newline));
+                w.buffer.erase(0, newline + 1);
+                size_t i;
+                RunResult result;
+                if(f[0] == "READY")
+                    dispatch(fd, w);
+                else if(f[0] == "RESULT" && parseResult(f, i, result) && static_cast<long long>(i) == w.run)
+                {
+                    writer.add(i, &result);
+                    ++finished;
+                    w.run = -1;
+                }
+                else
+                    valid = false;
+            }
+            if(!valid)
+                drop(fd);
+        }
+    }
+
+    //closing with a worker's READY unread would reset the connection before DONE is read, so
+    //wait for the workers to hang up first
+    for(auto& w: workers)
+    {
+        sendAll(w.first, "DONE\n");
+        shutdown(w.first, SHUT_WR);
+        char chunk[256];
+        while(recv(w.first, chunk, sizeof(chunk), 0) > 0)
+            ;
+        close(w.first);
+    }
+    close(listenFd);
+    if(!socketPath.empty())
+        unlink(socketPath.c_str());
+    if(failed > 0)
+    {
+        error = to_string(failed) + " runs failed after " + to_string(MAX_RUN_ATTEMPTS) + " attempts";
+        return false;
+    }
+    return true;
+}
+
+bool runWorker(const string& address, string& error)
+{
+    int fd = -1;
+    for(int waited = 0; fd < 0 && waited < CONNECT_TIMEOUT_MS; waited += CONNECT_RETRY_MS)
+        if((fd = connectTo(address)) < 0)
+            poll(nullptr, 0, CONNECT_RETRY_MS);
+    if(fd < 0)
+    {
+        error = "unable to connect to \"" + address + "\"";
+        return false;
+    }
+
+    //workloads are loaded on first use and kept for the following runs
+    map<string, vector<Process>> workloads;
+    string buffer, line;
+    bool connected = sendAll(fd, "READY\n");
+    while(connected && readLine(fd, buffer, line))
+    {
+        vector<string> f = fields(line);
+        if(f[0] == "DONE")
+        {
+            close(fd);
+            return true;
+        }
+        if(f[0] != "RUN" || f.size() != 12)
+            break;
+
+        ExperimentRun run = {0, stoi(f[3]), stoi(f[4]), stoi(f[5]), stoi(f[6]), stod(f[7]), stod(f[8])};
+        WorkloadSource source = {f[11], stoi(f[9]), stoll(f[10])};
+        auto found = workloads.find(source.name());
+        if(found == workloads.end())
+        {
+            found = workloads.emplace(source.name(), vector<Process>()).first;
+            source.load(found->second);
+        }
+        RunResult result = simulateRun(f[2] == "1", run, found->second);
+        connected = sendAll(fd, resultMessage(stoull(f[1]), result) + "READY\n");
+    }
+    close(fd);
+    error = "lost the connection to \"" + address + "\"";
+    return false;
+}
@@ -0,0 +1,33 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include "experiment.h"
+
+//Experiments split across worker processes, on this machine or others. The coordinator holds the
+//experiment's runs and listens on an address (see sockets.h); workers connect to it and pull one
+//run at a time, so faster workers simply take more runs. A run held by a worker whose connection
+//drops (the worker died or was killed) goes back to the front of the queue and is retried up to
+//MAX_RUN_ATTEMPTS times, after which it is reported as failed. Results are written as they arrive,
+//in run order (see ResultWriter). Workers load workload files by path, so on several hosts the
+//files must be at the same path on each.
+//
+//The protocol is line based, with tab separated fields:
+//  worker:      READY
+//  coordinator: RUN <run> <slices> <policy> <quantum> <high> <low> <switch> <per working set> <generate> <seed> <path>
+//               or DONE once every run has a result
+//  worker:      RESULT <run> <the RunResult fields in declaration order>, then READY again
+
+//times a run is handed out before it counts as failed
+const int MAX_RUN_ATTEMPTS = 3;
+
+//Serves the runs of spec to workers connecting to address (":<port>" listens on every interface)
+//and writes their results. Returns false and sets error if the address or a sink can't be opened,
+//or if some runs failed.
+bool coordinateExperiment(const ExperimentSpec& spec, const string& address, string& error);
+
+//Connects to the coordinator at address, retrying for a while if it isn't up yet, and simulates
+//the runs it hands out until it has none left. Returns false and sets error if the connection
+//can't be made or is lost.
+bool runWorker(const string& address, string& error);
+
+#endif
@@ -0,0 +1,256 @@
+#include<thread>
+#include<mutex>
+#include<condition_variable>
+#include<chrono>     // calibration, wall clock turnaround
+#include<iomanip>    // setw
+#include<iostream>
+#include<algorithm>  // nth_element
+#ifdef __linux__
+#include<pthread.h>  // pthread_setaffinity_np
+#endif
+#include "emulation.h"
+
+using namespace std::chrono;
+
+//how far ahead of a run's start the dispatcher stops sleeping and spins, since a sleep can
+//overshoot by more than a time step
+static const microseconds SPIN_AHEAD(200);
+
+//what an emulated process carries from one run to the next
+struct EmulatedProcess
+{
+    vector<char> memory;   //its working set
+    size_t pos = 0;        //next cache line to touch
+    uint64_t state = 1;    //the multiply chain, kept so the work can't be optimized away
+};
+
+//the busy work of a process running for iterations steps
+static void runKernel(EmulatedProcess& p, long long iterations)
+{
+    uint64_t x = p.state;
+    char* memory = p.memory.data();
+    size_t size = p.memory.size(), pos = p.pos;
+    for(long long i = 0; i < iterations; ++i)
+    {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        if(size)
+        {
+            memory[pos] += x;
+            pos += 64;
+            if(pos >= size)
+                pos = 0;
+        }
+    }
+    p.state = x;
+    p.pos = pos;
+}
+
+//kernel iterations that take tickUs on this machine, with a working set that stays in cache
+static long long calibrate(int tickUs, size_t workingSet)
+{
+    EmulatedProcess p;
+    p.memory.resize(workingSet);
+    long long iterations = 1 << 16, done = 0;
+    auto start = steady_clock::now();
+    while(steady_clock::now() - start < milliseconds(20))
+    {
+        runKernel(p, iterations);
+        done += iterations;
+    }
+    long long elapsedUs = duration_cast<microseconds>(steady_clock::now() - start).count();
+    return max(1LL, done * tickUs / max(elapsedUs, 1LL));
+}
+
+//Threads pinned one to a core that run a process's busy work at a time for the dispatcher. A job
+//goes to whichever idle worker takes it first, not to a worker of the process's own.
+class WorkerPool
+{
+public:
+    WorkerPool() : job(nullptr), iterations(0), ranOn(-1), quit(false) {}
+
+    ~WorkerPool()
+    {
+        {
+            lock_guard<mutex> lock(m);
+            quit = true;
+        }
+        wake.notify_all();
+        for(auto& t: runners)
+            t.join();
+    }
+
+    //starts a worker on each of the cores 0 to cores - 1, returning false with the core set if
+    //one can't be pinned
+    bool start(int cores, int& core)
+    {
+        for(core = 0; core < cores; ++core)
+        {
+            runners.emplace_back(&WorkerPool::loop, this, core);
+            if(!pin(runners.back(), core))
+                return false;
+        }
+        return true;
+    }
+
+    //runs iterations of p's busy work on a worker, waits for it to finish and returns the core it ran on
+    int run(EmulatedProcess& p, long long n)
+    {
+        unique_lock<mutex> lock(m);
+        job = &p;
+        iterations = n;
+        ranOn = -1;
+        wake.notify_one();
+        finished.wait(lock, [this]() { return ranOn >= 0; });
+        return ranOn;
+    }
+
+private:
+    static bool pin(thread& t, int core)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        return pthread_setaffinity_np(t.native_handle(), sizeof(set), &set) == 0;
+#else
+        (void)t;
+        (void)core;
+        return false;
+#endif
+    }
+
+    void loop(int core)
+    {
+        unique_lock<mutex> lock(m);
+        while(true)
+        {
+            wake.wait(lock, [this]() { return job != nullptr || quit; });
+            if(quit)
+                return;
+            //taken, so no other worker runs it too
+            EmulatedProcess* p = job;
+            long long n = iterations;
+            job = nullptr;
+            lock.unlock();
+            runKernel(*p, n);
+            lock.lock();
+            ranOn = core;
+            finished.notify_one();
+        }
+    }
+
+    mutex m;
+    condition_variable wake;       //a job or quit was posted
+    condition_variable finished;   //the job is done
+    EmulatedProcess* job;          //job waiting for a worker, null once one took it
+    long long iterations;
+    int ranOn;                     //core that ran the last job, -1 while it runs
+    bool quit;
+    vector<thread> runners;
+};
+
+bool emulateSchedule(const ScheduleTimeline& timeline, const vector<Process>& procList, int tickUs, int cores,
+                     EmulationResult& result, string& error)
+{
+    result = EmulationResult{tickUs, cores, vector<double>(procList.size(), 0), 0, 0, 0, 0};
+    int available = thread::hardware_concurrency();
+    if(cores < 1 || (available > 0 && cores > available))
+    {
+        error = "Can't emulate on " + to_string(cores) + " cores, the machine has " + to_string(available);
+        return false;
+    }
+    WorkerPool workers;
+    int core;
+    if(!workers.start(cores, core))
+    {
+        error = "Unable to pin a worker thread to core " + to_string(core);
+        return false;
+    }
+    long long computeIterations = calibrate(tickUs, 0);
+    long long memoryIterations = calibrate(tickUs, EMULATED_PAGE_SIZE);
+
+    vector<unique_ptr<EmulatedProcess>> processes(procList.size());
+    vector<int> lastCore(procList.size(), -1);
+    auto begin = steady_clock::now();
+    for(size_t i = 0; i < timeline.size(); ++i)
+    {
+        const ScheduleInterval& run = timeline.interval(i);
+        if(run.reason == RunReason::SWITCH)
+            continue;
+        auto due = begin + microseconds(static_cast<long long>(run.start) * tickUs);
+        if(steady_clock::now() < due - SPIN_AHEAD)
+            this_thread::sleep_until(due - SPIN_AHEAD);
+        auto now = steady_clock::now();
+        while(now < due)
+            now = steady_clock::now();
+        result.behindUs += duration_cast<microseconds>(now - due).count();
+
+        unique_ptr<EmulatedProcess>& p = processes[run.process];
+        if(!p)
+        {
+            p.reset(new EmulatedProcess);
+            p->memory.resize(workingSet(procList[run.process]) * EMULATED_PAGE_SIZE);
+        }
+        long long perStep = p->memory.empty() ? computeIterations : memoryIterations;
+        int ranOn = workers.run(*p, (run.end - run.start) * perStep);
+        ++result.dispatches;
+        if(lastCore[run.process] >= 0 && lastCore[run.process] != ranOn)
+            ++result.migrations;
+        lastCore[run.process] = ranOn;
+
+        if(run.reason == RunReason::COMPLETED)
+        {
+            double finish = duration_cast<microseconds>(steady_clock::now() - begin).count() / static_cast<double>(tickUs);
+            result.turnaround[run.process] = finish - procList[run.process].startTime;
+            result.finish = max(result.finish, finish);
+            p.reset();
+        }
+    }
+    return true;
+}
+
+//nearest rank percentile, reordering values
+static double percentile(vector<double>& values, int pct)
+{
+    if(values.empty())
+        return 0;
+    size_t rank = (values.size() * pct + 99) / 100;
+    nth_element(values.begin(), values.begin() + max(rank, static_cast<size_t>(1)) - 1, values.end());
+    return values[max(rank, static_cast<size_t>(1)) - 1];
+}
+
+void printEmulation(const vector<Process>& procList, const EmulationResult& result)
+{
+    vector<double> simulated, emulated = result.turnaround;
+    double simulatedSum = 0, emulatedSum = 0, simulatedNormalized = 0, emulatedNormalized = 0, simulatedFinish = 0;
+    for(size_t i = 0; i < procList.size(); ++i)
+    {
+        const Process& p = procList[i];
+        simulated.push_back(p.timeFinished + 1 - p.startTime);
+        simulatedFinish = max(simulatedFinish, static_cast<double>(p.timeFinished + 1));
+        simulatedSum += simulated.back();
+        emulatedSum += emulated[i];
+        simulatedNormalized += simulated.back() / p.totalTimeNeeded;
+        emulatedNormalized += emulated[i] / p.totalTimeNeeded;
+    }
+    double n = max(procList.size(), static_cast<size_t>(1));
+
+    cout << "\nEmulated at " << result.tickUs << " us per time step on " << result.cores << " pinned core"
+         << (result.cores == 1 ? "" : "s") << ":\n"
+         << "                    Metric |   Simulated |    Emulated |    Slowdown |\n"
+         << string(70, '-') << "\n" << setprecision(2) << fixed;
+    auto row = [](const char* name, double simulated, double emulated)
+    {
+        cout << setw(26) << name << " |" << setw(12) << simulated << " |" << setw(12) << emulated << " |"
+             << setw(11) << emulated / max(simulated, 1e-9) << "x |\n";
+    };
+    row("Finish time", simulatedFinish, result.finish);
+    row("Mean turnaround", simulatedSum / n, emulatedSum / n);
+    row("90th turnaround", percentile(simulated, 90), percentile(emulated, 90));
+    row("99th turnaround", percentile(simulated, 99), percentile(emulated, 99));
+    row("Max turnaround", percentile(simulated, 100), percentile(emulated, 100));
+    row("Mean normalized turnaround", simulatedNormalized / n, emulatedNormalized / n);
+    cout << "Dispatches: " << result.dispatches << " (" << result.migrations << " to another core than the process's last run)"
+         << ", started behind the schedule by " << result.behindUs << " us in total ("
+         << result.behindUs / max(result.dispatches, 1LL) << " us on average)\n";
+}
@@ -0,0 +1,41 @@
+#ifndef EMULATION_H
+#define EMULATION_H
+
+#include<string>
+#include "timeline.h"
+
+using namespace std;
+
+//bytes of memory an emulated process touches per unit of working set
+const size_t EMULATED_PAGE_SIZE = 4096;
+
+//What running a schedule on the hardware measured
+struct EmulationResult
+{
+    int tickUs;                 //wall clock time given to a time step
+    int cores;                  //cores the workers were pinned to
+    vector<double> turnaround;  //each process's wall clock turnaround, in time steps
+    double finish;              //wall clock time the last process finished, in time steps
+    long long dispatches;       //runs handed to the workers
+    long long migrations;       //runs on another core than the process's previous run
+    long long behindUs;         //total time runs started later than the schedule had them
+};
+
+//Runs the schedule in timeline on the hardware. Each time step a process runs in the schedule
+//becomes tickUs of calibrated busy work: a dependent multiply chain that also walks the
+//process's working set (EMULATED_PAGE_SIZE bytes per unit) a cache line per step. The work runs
+//on one worker thread per core, pinned to cores 0 to cores - 1; a dispatcher hands out the runs in
+//the schedule's order and waits for each, and whichever idle worker takes a run first runs it. A
+//process can so move between cores from one run to the next, paying for its working set's cache
+//lines on the new core, and each move is counted as a migration. A run
+//starts no earlier than its simulated start time on the wall clock, which also stands in for
+//arrivals and IO, but later if the runs before it took longer than the model said. Context
+//switch intervals aren't emulated: the real cost of switching is part of what is measured.
+//Returns false with error set if the workers can't be pinned.
+bool emulateSchedule(const ScheduleTimeline& timeline, const vector<Process>& procList, int tickUs, int cores,
+                     EmulationResult& result, string& error);
+
+//prints the simulated turnaround statistics next to the emulated ones
+void printEmulation(const vector<Process>& procList, const EmulationResult& result);
+
+#endif
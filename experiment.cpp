@@ -0,0 +1,652 @@
+#include<atomic>   // next run to take
+#include<thread>   // worker threads
+#include<chrono>   // run times
+#include<random>   // generated workloads
+#include<iomanip>  // setprecision
+#include<memory>   // unique_ptr
+#include<cstring>  // strncmp
+#include<climits>  // INT_MAX
+#include<cmath>    // fabs
+#include<array>
+#include<algorithm> // find, count
+#include "experiment.h"
+#include "traceImport.h"
+#include "stats.h"
+#include "analytic.h"
+#include "workloadOverlay.h"
+
+using namespace std::chrono;
+
+//highest scheduler choice of the main menu
+static const int NUM_POLICIES = 11;
+
+//the main menu's names of the schedulers, by choice
+static const char* const POLICY_NAMES[NUM_POLICIES + 1] = {"", "Round Robin", "Shortest Process Next",
+    "Shortest Remaining Time", "Highest Response Ratio Next", "Modified HRRN", "First In First Out",
+    "Multilevel Queue", "Multilevel Feedback Queue", "Earliest Deadline First", "Non-preemptive EDF", "Least Laxity First"};
+
+//measurements of a run that replicas report, and their names in stopOn
+static const int NUM_REPLICA_METRICS = 12;
+static const char* const REPLICA_METRICS[NUM_REPLICA_METRICS] = {"finish", "turnaround", "normalized", "wait", "io",
+    "p90", "p99", "max", "switches", "overhead", "misses", "tardiness"};
+
+//their column names in the replica results
+static const char* const REPLICA_COLUMNS[NUM_REPLICA_METRICS] = {"Finish Time", "Turnaround Time",
+    "Normalized Turnaround Time", "CPU Wait Time", "IO Time", "90th Percentile Turnaround Time",
+    "99th Percentile Turnaround Time", "Max Turnaround Time", "Context Switches", "Switch Overhead", "Deadline Miss Ratio",
+    "Mean Tardiness"};
+
+static string trim(const string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r");
+    if(begin == string::npos)
+        return "";
+    return s.substr(begin, s.find_last_not_of(" \t\r") - begin + 1);
+}
+
+//splits a list value at its commas, trimming the items
+static vector<string> splitList(const string& value)
+{
+    vector<string> items;
+    size_t begin = 0;
+    while(true)
+    {
+        size_t comma = value.find(',', begin);
+        string item = trim(value.substr(begin, comma == string::npos ? string::npos : comma - begin));
+        if(!item.empty())
+            items.push_back(item);
+        if(comma == string::npos)
+            return items;
+        begin = comma + 1;
+    }
+}
+
+//appends an integer list value (items and "lo..hi" ranges) to list
+static bool parseIntList(const string& value, vector<long long>& list)
+{
+    for(const string& item: splitList(value))
+    {
+        char* end;
+        long long lo = strtoll(item.c_str(), &end, 10), hi = lo;
+        if(end == item.c_str())
+            return false;
+        if(strncmp(end, "..", 2) == 0)
+        {
+            const char* rest = end + 2;
+            hi = strtoll(rest, &end, 10);
+            if(end == rest)
+                return false;
+        }
+        if(*end != '\0' || hi < lo)
+            return false;
+        for(long long v = lo; v <= hi; ++v)
+            list.push_back(v);
+    }
+    return true;
+}
+
+static bool parseDoubleList(const string& value, vector<double>& list)
+{
+    for(const string& item: splitList(value))
+    {
+        char* end;
+        list.push_back(strtod(item.c_str(), &end));
+        if(end == item.c_str() || *end != '\0')
+            return false;
+    }
+    return true;
+}
+
+bool readExperimentSpec(const string& fname, ExperimentSpec& spec, string& error)
+{
+    ifstream in(fname.c_str());
+    if(in.fail())
+    {
+        error = "unable to open \"" + fname + "\"";
+        return false;
+    }
+
+    string line;
+    for(int lineNum = 1; getline(in, line); ++lineNum)
+    {
+        line = trim(line.substr(0, line.find('#')));
+        if(line.empty())
+            continue;
+        size_t eq = line.find('=');
+        string key = trim(line.substr(0, eq)), value = eq == string::npos ? "" : trim(line.substr(eq + 1));
+        vector<long long> ints;
+        bool valid = eq != string::npos;
+
+        if(!valid)
+            ;
+        else if(key == "workload" || key == "workloads")
+            for(const string& item: splitList(value))
+                spec.workloads.push_back(item);
+        else if(key == "generate")
+        {
+            valid = parseIntList(value, ints) && ints.size() == 1 && ints[0] > 0;
+            spec.generateProcs = valid ? ints[0] : 0;
+        }
+        else if(key == "seeds" || key == "seed")
+            valid = parseIntList(value, spec.seeds);
+        else if(key == "policies" || key == "policy")
+            valid = parseIntList(value, spec.policies);
+        else if(key == "quantum" || key == "quanta")
+            valid = parseIntList(value, spec.quanta);
+        else if(key == "high")
+            valid = parseIntList(value, spec.highQuanta);
+        else if(key == "low")
+            valid = parseIntList(value, spec.lowQuanta);
+        else if(key == "switch")
+            valid = parseDoubleList(value, spec.switchCosts);
+        else if(key == "switchPerWorkingSet")
+            valid = parseDoubleList(value, spec.switchCostsPerWorkingSet);
+        else if(key == "engine")
+        {
+            valid = value == "ticks" || value == "slices";
+            spec.slices = value == "slices";
+        }
+        else if(key == "output")
+            for(const string& item: splitList(value))
+                spec.outputs.push_back(item);
+        else if(key == "threads")
+        {
+            valid = parseIntList(value, ints) && ints.size() == 1 && ints[0] >= 0;
+            spec.threads = valid ? ints[0] : 1;
+        }
+        else if(key == "replicas")
+        {
+            //a range is taken by its ends rather than expanded
+            size_t dots = value.find("..");
+            valid = parseIntList(value.substr(0, dots), ints) && (dots == string::npos || parseIntList(value.substr(dots + 2), ints))
+                    && ints.size() == (dots == string::npos ? 1u : 2u) && ints.front() >= 1 && ints.front() <= ints.back() && ints.back() <= INT_MAX;
+            spec.minReplicas = valid ? ints.front() : 0;
+            spec.maxReplicas = valid ? ints.back() : 0;
+        }
+        else if(key == "precision" || key == "confidence")
+        {
+            vector<double> values;
+            valid = parseDoubleList(value, values) && values.size() == 1 && values[0] > 0 && (key == "precision" || values[0] < 1);
+            (key == "precision" ? spec.precision : spec.confidence) = valid ? values[0] : 0;
+        }
+        else if(key == "burstNoise" || key == "priorityFlips")
+        {
+            vector<double> values;
+            valid = parseDoubleList(value, values) && values.size() == 1 && values[0] >= 0 && (key == "burstNoise" || values[0] <= 1);
+            (key == "burstNoise" ? spec.perturbation.burstNoise : spec.perturbation.priorityFlips) = valid ? values[0] : 0;
+        }
+        else if(key == "arrivalJitter")
+        {
+            valid = parseIntList(value, ints) && ints.size() == 1 && ints[0] >= 0 && ints[0] <= INT_MAX / 2;
+            spec.perturbation.arrivalJitter = valid ? ints[0] : 0;
+        }
+        else if(key == "stopOn")
+            for(const string& item: splitList(value))
+            {
+                int m = find(REPLICA_METRICS, REPLICA_METRICS + NUM_REPLICA_METRICS, item) - REPLICA_METRICS;
+                valid = valid && m < NUM_REPLICA_METRICS;
+                spec.stopOn.push_back(m);
+            }
+        else
+        {
+            error = fname + ":" + to_string(lineNum) + ": unknown key \"" + key + "\"";
+            return false;
+        }
+        if(!valid)
+        {
+            error = fname + ":" + to_string(lineNum) + ": invalid value for \"" + key + "\"";
+            return false;
+        }
+    }
+
+    //defaults
+    if(spec.seeds.empty())
+        spec.seeds.push_back(1);
+    if(spec.policies.empty())
+        for(int choice = 1; choice <= NUM_POLICIES; ++choice)
+            spec.policies.push_back(choice);
+    if(spec.switchCosts.empty())
+        spec.switchCosts.push_back(0);
+    if(spec.switchCostsPerWorkingSet.empty())
+        spec.switchCostsPerWorkingSet.push_back(0);
+    if(spec.outputs.empty())
+        spec.outputs.push_back("stdout");
+    if(spec.stopOn.empty())
+        spec.stopOn = {1, 2};
+
+    if(spec.workloads.empty() && spec.generateProcs == 0)
+        error = "no workload or generate given";
+    if(spec.perturbation.any() && (spec.maxReplicas == 0 || spec.workloads.empty() || spec.generateProcs > 0))
+        error = "perturbations need replicas and are of workload files only";
+    else if(spec.maxReplicas > 0 && !spec.perturbation.any() && (!spec.workloads.empty() || spec.generateProcs == 0))
+        error = "replicas of workload files need a perturbation";
+    for(long long choice: spec.policies)
+    {
+        if(choice < 1 || choice > NUM_POLICIES)
+            error = "unknown policy " + to_string(choice);
+        else if((choice == 1 || choice == 7 || choice == 8) && spec.quanta.empty())
+            error = "policy " + to_string(choice) + " needs a quantum";
+        else if(choice == 8 && (spec.highQuanta.empty() || spec.lowQuanta.empty()))
+            error = "policy 8 needs high and low quanta";
+    }
+    for(long long q: spec.quanta)
+        if(q < 1)
+            error = "quanta must be positive";
+    for(long long q: spec.highQuanta)
+        if(q < 1)
+            error = "high quanta must be positive";
+    if(!error.empty())
+    {
+        error = fname + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+string WorkloadSource::name() const
+{
+    if(!path.empty())
+        return path;
+    return "generated(" + to_string(generateProcs) + ",seed=" + to_string(seed) + ")";
+}
+
+//a random workload of numProcs processes, made like the procCreate lists
+static void generateWorkload(int numProcs, long long seed, vector<Process>& procList)
+{
+    mt19937 random(seed);
+    procList.resize(numProcs);
+    for(int i = 0; i < numProcs; ++i)
+    {
+        Process& p = procList[i];
+        setProcessName(p, "p" + to_string(i + 1));
+        p.startTime = random() % (numProcs + 1);
+        p.totalTimeNeeded = random() % 10 + 1;
+        p.priority = random() % 2;
+    }
+}
+
+void WorkloadSource::load(vector<Process>& procList) const
+{
+    if(!path.empty())
+        readInWorkload(path, procList);
+    else
+        generateWorkload(generateProcs, seed, procList);
+}
+
+RunResult simulateRun(bool slices, const ExperimentRun& run, const vector<Process>& workload)
+{
+    vector<Process> procList = workload;
+    SwitchModel switches(run.switchCost, run.switchCostPerWorkingSet);
+    RunResult result = {};
+
+    auto start = high_resolution_clock::now();
+    //the slice engine is skipped where the schedule has a closed form (see analytic.h)
+    if(!slices || !evaluateAnalytic(run.policy, procList, switches, result.lastTime))
+        withScheduler(run.policy, run.quantum, run.highQuantum, run.lowQuantum, [&](auto& sched)
+        {
+            result.lastTime = slices ? simulateSlices(sched, procList, switches) : simulate(sched, procList, false, switches);
+        });
+    auto stop = high_resolution_clock::now();
+    result.runtimeUs = duration_cast<microseconds>(stop - start).count();
+    summarizeRun(procList, switches, result);
+    return result;
+}
+
+void summarizeRun(const vector<Process>& procList, const SwitchModel& switches, RunResult& result)
+{
+    ProcessColumns columns;
+    RunStats stats;
+    vector<uint8_t> buckets;
+    columns.load(procList);
+    computeRunStats(columns, stats, &buckets);
+    result.avgTurnaround = stats.meanTurnaround();
+    result.avgNormalizedTurnaround = stats.meanNormalizedTurnaround();
+    result.avgCpuWait = stats.meanCpuWait();
+    result.avgIoTime = stats.meanIo();
+    result.turnaround90 = turnaroundPercentile(columns, stats, buckets, 90);
+    result.turnaround99 = turnaroundPercentile(columns, stats, buckets, 99);
+    result.maxTurnaround = stats.maxTurnaround;
+    result.switches = switches.count();
+    result.switchOverhead = switches.totalOverhead() / (result.lastTime + 1);
+    DeadlineStats deadlines;
+    computeDeadlineStats(columns, deadlines);
+    result.deadlineMissRatio = deadlines.missRatio();
+    result.meanTardiness = deadlines.meanTardiness;
+    result.tardiness90 = deadlines.tardiness90;
+    result.tardiness99 = deadlines.tardiness99;
+    result.maxTardiness = deadlines.maxTardiness;
+}
+
+//Simulates every run, on up to numThreads threads (0 for one per core). Workers take the runs in
+//order and each result has its own slot, so the results don't depend on the thread count.
+static vector<RunResult> runAll(const vector<ExperimentRun>& runs, const vector<const vector<Process>*>& workloads, bool slices, int numThreads)
+{
+    vector<RunResult> results(runs.size());
+    atomic<size_t> nextRun(0);
+    auto work = [&]()
+    {
+        for(size_t i; (i = nextRun++) < runs.size();)
+            results[i] = simulateRun(slices, runs[i], *workloads[runs[i].workload]);
+    };
+    if(numThreads <= 0)
+        numThreads = max(1u, thread::hardware_concurrency());
+    vector<thread> workers;
+    for(int t = 1; t < numThreads && t < static_cast<int>(runs.size()); ++t)
+        workers.emplace_back(work);
+    work();
+    for(auto& worker: workers)
+        worker.join();
+    return results;
+}
+
+vector<WorkloadSource> workloadSources(const ExperimentSpec& spec)
+{
+    vector<WorkloadSource> sources;
+    for(const string& fname: spec.workloads)
+        sources.push_back({fname, 0, 0});
+    if(spec.generateProcs > 0)
+        for(long long seed: spec.seeds)
+            sources.push_back({"", spec.generateProcs, seed});
+    return sources;
+}
+
+vector<ExperimentRun> expandRuns(const ExperimentSpec& spec, int numWorkloads)
+{
+    vector<ExperimentRun> runs;
+    vector<long long> none(1, 0);
+    for(int w = 0; w < numWorkloads; ++w)
+        for(long long choice: spec.policies)
+        {
+            bool quantum = choice == 1 || choice == 7 || choice == 8, feedback = choice == 8;
+            for(long long q: quantum ? spec.quanta : none)
+                for(long long high: feedback ? spec.highQuanta : none)
+                    for(long long low: feedback ? spec.lowQuanta : none)
+                        for(double cost: spec.switchCosts)
+                            for(double perWs: spec.switchCostsPerWorkingSet)
+                                runs.push_back({w, static_cast<int>(choice), static_cast<int>(q),
+                                                static_cast<int>(high), static_cast<int>(low), cost, perWs});
+        }
+    return runs;
+}
+
+//opens the output sinks, files going in files; returns false and sets error if one can't be opened
+static bool openSinks(const vector<string>& outputs, vector<unique_ptr<ofstream>>& files, vector<ostream*>& sinks, string& error)
+{
+    for(const string& output: outputs)
+    {
+        if(output == "stdout")
+        {
+            sinks.push_back(&cout);
+            continue;
+        }
+        files.emplace_back(new ofstream(output.c_str()));
+        if(files.back()->fail())
+        {
+            error = "unable to open \"" + output + "\"";
+            return false;
+        }
+        sinks.push_back(files.back().get());
+    }
+    return true;
+}
+
+bool ResultWriter::open(const ExperimentSpec& spec, const vector<WorkloadSource>& sources, const vector<ExperimentRun>& runs, string& error)
+{
+    this->sources = &sources;
+    this->runs = &runs;
+    results.assign(runs.size(), RunResult());
+    state.assign(runs.size(), 0);
+    written = 0;
+    if(!openSinks(spec.outputs, files, sinks, error))
+        return false;
+    for(ostream* out: sinks)
+        *out << "Workload,Policy,Quantum,High Quantum,Low Quantum,Switch Cost,Switch Cost Per Working Set,"
+             << "Finish Time,Turnaround Time,Normalized Turnaround Time,CPU Wait Time,IO Time,"
+             << "90th Percentile Turnaround Time,99th Percentile Turnaround Time,Max Turnaround Time,Context Switches,Switch Overhead,Runtime,"
+             << "Deadline Miss Ratio,Mean Tardiness,90th Percentile Tardiness,99th Percentile Tardiness,Max Tardiness\n"
+             << setprecision(6) << flush;
+    return true;
+}
+
+void ResultWriter::add(size_t i, const RunResult* result)
+{
+    state[i] = result ? 1 : 2;
+    if(result)
+        results[i] = *result;
+    if(i != written)
+        return;
+    while(written < state.size() && state[written] != 0)
+        writeRow(written++);
+    for(ostream* out: sinks)
+        out->flush();
+}
+
+void ResultWriter::writeRow(size_t i)
+{
+    const ExperimentRun& run = (*runs)[i];
+    const RunResult& r = results[i];
+    for(ostream* sink: sinks)
+    {
+        ostream& out = *sink;
+        out << '"' << (*sources)[run.workload].name() << "\"," << run.policy << "," << run.quantum << "," << run.highQuantum << ","
+            << run.lowQuantum << "," << run.switchCost << "," << run.switchCostPerWorkingSet << ",";
+        if(state[i] == 2)
+        {
+            //the measurement columns of a run that couldn't be simulated are left empty
+            out << ",,,,,,,,,,,,,,,\n";
+            continue;
+        }
+        out << r.lastTime + 1 << "," << r.avgTurnaround << "," << r.avgNormalizedTurnaround << "," << r.avgCpuWait << ","
+            << r.avgIoTime << "," << r.turnaround90 << "," << r.turnaround99 << "," << r.maxTurnaround << "," << r.switches << ","
+            << r.switchOverhead << "," << r.runtimeUs << "," << r.deadlineMissRatio << "," << r.meanTardiness << ","
+            << r.tardiness90 << "," << r.tardiness99 << "," << r.maxTardiness << "\n";
+    }
+}
+
+//the measurements of a run, in REPLICA_METRICS order
+static array<double, NUM_REPLICA_METRICS> replicaMetrics(const RunResult& r)
+{
+    return {{static_cast<double>(r.lastTime + 1), r.avgTurnaround, r.avgNormalizedTurnaround, r.avgCpuWait, r.avgIoTime,
+             static_cast<double>(r.turnaround90), static_cast<double>(r.turnaround99), static_cast<double>(r.maxTurnaround),
+             static_cast<double>(r.switches), r.switchOverhead, r.deadlineMissRatio, r.meanTardiness}};
+}
+
+//Runs each configuration of the spec on replicas, generated or perturbed from each workload file,
+//until its stopOn intervals are within the precision (see "replicas" in experiment.h), and writes
+//one row per workload and configuration.
+//
+//Replicas are simulated in rounds, each running a batch of the next replicas of every cell (a
+//workload and a configuration) still going, enough to keep the threads busy. Each cell then takes
+//the round's results in replica order, stopping at the one that settles it; any after that are
+//dropped, so what a cell reports doesn't depend on the batch size.
+static bool runReplicas(const ExperimentSpec& spec, string& error)
+{
+    vector<ExperimentRun> configs = expandRuns(spec, 1);
+    vector<unique_ptr<ofstream>> files;
+    vector<ostream*> sinks;
+    if(!openSinks(spec.outputs, files, sinks, error))
+        return false;
+
+    //perturbed replicas are overlays on the workload files, simulated once as they are for the base
+    bool perturbing = spec.perturbation.any();
+    vector<WorkloadSource> sources = perturbing ? workloadSources(spec) : vector<WorkloadSource>(1, {"", spec.generateProcs, 0});
+    vector<vector<Process>> bases(perturbing ? sources.size() : 0);
+    vector<const vector<Process>*> basePtrs;
+    for(size_t w = 0; w < bases.size(); ++w)
+    {
+        sources[w].load(bases[w]);
+        basePtrs.push_back(&bases[w]);
+    }
+    vector<ExperimentRun> cells = expandRuns(spec, sources.size());
+    size_t numConfigs = configs.size();
+
+    int threads = spec.threads > 0 ? spec.threads : max(1u, thread::hardware_concurrency());
+    vector<RunResult> baseResults = perturbing ? runAll(cells, basePtrs, spec.slices, threads) : vector<RunResult>();
+    vector<array<RunningStats, NUM_REPLICA_METRICS>> stats(cells.size());
+    vector<long long> runtimeUs(cells.size(), 0);
+    vector<char> settled(cells.size(), 0);
+    vector<size_t> going(cells.size());
+    for(size_t c = 0; c < cells.size(); ++c)
+        going[c] = c;
+    long long simulated = 0, first = spec.seeds.front();
+    //the overlays' bursts go after the workloads' and are dropped after each round
+    size_t poolMark = burstPool().size();
+
+    for(int replica = 0; !going.empty(); )
+    {
+        int batch = min(max(threads / static_cast<int>(going.size()), 1), spec.maxReplicas - replica);
+        vector<char> needed(sources.size(), 0);
+        for(size_t c: going)
+            needed[c / numConfigs] = 1;
+        vector<vector<Process>> workloads(sources.size() * batch);
+        vector<const vector<Process>*> workloadPtrs;
+        for(size_t w = 0; w < workloads.size(); ++w)
+        {
+            size_t source = w / batch;
+            long long seed = first + replica + static_cast<long long>(w % batch);
+            if(needed[source] && perturbing)
+                WorkloadOverlay(bases[source], spec.perturbation, seed).apply(workloads[w]);
+            else if(needed[source])
+                WorkloadSource{"", spec.generateProcs, seed}.load(workloads[w]);
+            workloadPtrs.push_back(&workloads[w]);
+        }
+        vector<ExperimentRun> runs;
+        for(size_t c: going)
+            for(int b = 0; b < batch; ++b)
+            {
+                runs.push_back(cells[c]);
+                runs.back().workload = cells[c].workload * batch + b;
+            }
+        vector<RunResult> results = runAll(runs, workloadPtrs, spec.slices, threads);
+        burstPool().resize(poolMark);
+        simulated += runs.size();
+        replica += batch;
+
+        vector<size_t> stillGoing;
+        for(size_t g = 0; g < going.size(); ++g)
+        {
+            size_t c = going[g];
+            auto& metrics = stats[c];
+            for(int b = 0; b < batch && !settled[c]; ++b)
+            {
+                const RunResult& r = results[g * batch + b];
+                array<double, NUM_REPLICA_METRICS> values = replicaMetrics(r);
+                for(int m = 0; m < NUM_REPLICA_METRICS; ++m)
+                    metrics[m].add(values[m]);
+                runtimeUs[c] += r.runtimeUs;
+                //an interval needs two replicas at least
+                if(metrics[0].count < max(spec.minReplicas, 2))
+                    continue;
+                settled[c] = 1;
+                for(int m: spec.stopOn)
+                    if(metrics[m].halfWidth(spec.confidence) > spec.precision * fabs(metrics[m].mean))
+                        settled[c] = 0;
+            }
+            if(!settled[c] && replica < spec.maxReplicas)
+                stillGoing.push_back(c);
+        }
+        going.swap(stillGoing);
+    }
+
+    //perturbed rows also give each metric on the base workload and the change in its mean, the
+    //policy's sensitivity to the perturbation
+    long long used = 0;
+    for(ostream* out: sinks)
+    {
+        *out << "Workload,Policy,Quantum,High Quantum,Low Quantum,Switch Cost,Switch Cost Per Working Set,Replicas,Settled";
+        for(const char* column: REPLICA_COLUMNS)
+        {
+            if(perturbing)
+                *out << "," << column << " Base";
+            *out << "," << column << "," << column << " CI Low," << column << " CI High";
+            if(perturbing)
+                *out << "," << column << " Change";
+        }
+        *out << ",Runtime\n" << setprecision(6);
+    }
+    for(size_t c = 0; c < cells.size(); ++c)
+    {
+        const ExperimentRun& run = cells[c];
+        used += stats[c][0].count;
+        string name = perturbing ? sources[run.workload].name() : "generated(" + to_string(spec.generateProcs) + ")";
+        array<double, NUM_REPLICA_METRICS> base = perturbing ? replicaMetrics(baseResults[c]) : array<double, NUM_REPLICA_METRICS>();
+        for(ostream* out: sinks)
+        {
+            *out << '"' << name << "\"," << run.policy << "," << run.quantum << "," << run.highQuantum << ","
+                 << run.lowQuantum << "," << run.switchCost << "," << run.switchCostPerWorkingSet << ","
+                 << stats[c][0].count << "," << (settled[c] ? "yes" : "no");
+            for(int m = 0; m < NUM_REPLICA_METRICS; ++m)
+            {
+                const RunningStats& metric = stats[c][m];
+                double half = metric.halfWidth(spec.confidence);
+                if(perturbing)
+                    *out << "," << base[m];
+                *out << "," << metric.mean << "," << metric.mean - half << "," << metric.mean + half;
+                //relative to the base, empty where the base is 0
+                if(perturbing && base[m] != 0)
+                    *out << "," << (metric.mean - base[m]) / base[m];
+                else if(perturbing)
+                    *out << ",";
+            }
+            *out << "," << runtimeUs[c] << "\n";
+        }
+    }
+    for(ostream* out: sinks)
+        out->flush();
+    cerr << "Replicas: " << used << " of at most " << static_cast<long long>(cells.size()) * spec.maxReplicas << " used ("
+         << simulated << " simulated), " << count(settled.begin(), settled.end(), 1) << " of " << cells.size()
+         << (perturbing ? " cells" : " configurations") << " within " << spec.precision * 100 << "% at "
+         << spec.confidence * 100 << "% confidence" << endl;
+    return true;
+}
+
+bool runExperiment(const ExperimentSpec& spec, string& error)
+{
+    if(spec.maxReplicas > 0)
+        return runReplicas(spec, error);
+
+    //Load every workload up front: the id arena and burst pool are filled while loading, and
+    //the runs only read them
+    vector<WorkloadSource> sources = workloadSources(spec);
+    vector<vector<Process>> workloads(sources.size());
+    vector<const vector<Process>*> workloadPtrs;
+    for(size_t w = 0; w < sources.size(); ++w)
+    {
+        sources[w].load(workloads[w]);
+        workloadPtrs.push_back(&workloads[w]);
+    }
+    vector<ExperimentRun> runs = expandRuns(spec, sources.size());
+
+    //open the sinks before spending time on the runs
+    ResultWriter writer;
+    if(!writer.open(spec, sources, runs, error))
+        return false;
+    vector<RunResult> results = runAll(runs, workloadPtrs, spec.slices, spec.threads);
+    for(size_t i = 0; i < runs.size(); ++i)
+        writer.add(i, &results[i]);
+    return true;
+}
+
+void comparePolicies(const vector<Process>& workload, int timeQuantum, int highQuantum, int lowQuantum,
+                     double switchCost, double switchCostPerWorkingSet, bool slices)
+{
+    vector<ExperimentRun> runs;
+    for(int choice = 1; choice <= NUM_POLICIES; ++choice)
+        runs.push_back({0, choice, timeQuantum, highQuantum, lowQuantum, switchCost, switchCostPerWorkingSet});
+    vector<const vector<Process>*> workloads(1, &workload);
+    vector<RunResult> results = runAll(runs, workloads, slices, NUM_POLICIES);
+
+    cout << "\n\nPolicy Comparison:\n"
+         << "                     Policy | Finish Time | Mean Turnaround | 90th Turnaround | 99th Turnaround | Max Turnaround |"
+         << " Mean Normalized | CPU Wait Time | IO Time | Switches | Missed Deadlines (%) | 99th Tardiness | Runtime (us) |\n"
+         << string(217, '-') << "\n" << setprecision(2) << fixed;
+    for(size_t i = 0; i < runs.size(); ++i)
+    {
+        const RunResult& r = results[i];
+        cout << setw(27) << POLICY_NAMES[runs[i].policy] << " |" << setw(12) << r.lastTime + 1 << " |"
+             << setw(16) << r.avgTurnaround << " |" << setw(16) << r.turnaround90 << " |" << setw(16) << r.turnaround99 << " |"
+             << setw(15) << r.maxTurnaround << " |" << setw(16) << r.avgNormalizedTurnaround << " |"
+             << setw(14) << r.avgCpuWait << " |" << setw(8) << r.avgIoTime << " |" << setw(9) << r.switches << " |"
+             << setw(21) << 100 * r.deadlineMissRatio << " |" << setw(15) << r.tardiness99 << " |" << setw(13) << r.runtimeUs << " |\n";
+    }
+}
@@ -0,0 +1,175 @@
+#ifndef EXPERIMENT_H
+#define EXPERIMENT_H
+
+#include<memory>   // unique_ptr
+#include "simulator.h"
+#include "workloadOverlay.h"
+
+//Headless batches of simulations described by an experiment spec file. A spec is a list of
+//"key = value" lines; "#" starts a comment. List values are separated by commas, integer lists
+//may contain ranges "lo..hi", and repeating a key appends to its list.
+//
+//  workload = <file>[, <file>...]   process lists or traces to simulate (see readInWorkload)
+//  generate = <processes>           also simulate one random workload per seed, made like the
+//                                   procCreate lists: arrivals in 0..processes, bursts 1-10,
+//                                   priorities 0 or 1
+//  seeds = <seed>[, ...]            seeds for the generated workloads (default 1)
+//  policies = <choice>[, ...]       schedulers, numbered as in the main menu (default all)
+//  quantum = <q>[, ...]             time quanta of Round Robin and the multilevel queues
+//  high = <q>[, ...]                Multilevel Feedback Queue demotion quanta
+//  low = <q>[, ...]                 Multilevel Feedback Queue promotion quanta
+//  switch = <cost>[, ...]           context switch costs (see switchModel.h, default 0)
+//  switchPerWorkingSet = <cost>[, ...]
+//  engine = ticks | slices          simulation loop (default slices)
+//  output = <file.csv> | stdout     where the results go; several sinks may be given
+//  threads = <n>                    runs simulated at once (default 1, 0 for one per core)
+//  replicas = <min>..<max> | <n>    replicate each configuration over generated or perturbed
+//                                   workloads until its confidence intervals are narrow enough
+//                                   (see below)
+//  precision = <fraction>           target confidence interval half width, relative to the mean
+//                                   (default 0.05)
+//  confidence = <level>             confidence level of the intervals (default 0.95)
+//  burstNoise = <fraction>          perturb replicas of the workload files instead (see
+//  arrivalJitter = <ticks>          workloadOverlay.h)
+//  priorityFlips = <probability>
+//  stopOn = <metric>[, ...]         metrics whose intervals must reach the precision: finish,
+//                                   turnaround, normalized, wait, io, p90, p99, max, switches,
+//                                   overhead, misses, tardiness (default turnaround, normalized)
+//
+//Every combination of workload, policy and switch cost is run, for each policy with every
+//combination of the quanta it takes. Results are written in that order, one CSV row per run,
+//whatever the thread count.
+//
+//With replicas, each configuration is run on replicas of a workload: replica k is the random
+//workload of seed first seed + k or, with a perturbation, the perturbation of each workload file
+//drawn from that seed (the same replicas for every configuration). Replicas are simulated on
+//demand, the running mean and variance of each metric updated as each comes in, until at least
+//min (and two) have run and the stopOn metrics' intervals are within the precision, or max have
+//run. One row is written per workload and configuration instead, with the replicas it took and
+//each metric's mean and interval bounds; perturbed rows also give the metric on the unperturbed
+//workload and the relative change of the mean from it. The rows don't depend on the thread count.
+struct ExperimentSpec
+{
+    ExperimentSpec() : generateProcs(0), slices(true), threads(1), minReplicas(0), maxReplicas(0), precision(0.05), confidence(0.95) {}
+
+    vector<string> workloads;
+    int generateProcs;
+    vector<long long> seeds;
+    vector<long long> policies;
+    vector<long long> quanta;
+    vector<long long> highQuanta;
+    vector<long long> lowQuanta;
+    vector<double> switchCosts;
+    vector<double> switchCostsPerWorkingSet;
+    bool slices;
+    vector<string> outputs;
+    int threads;
+    int minReplicas;
+    int maxReplicas;            //0 without replicas
+    double precision;
+    double confidence;
+    Perturbation perturbation;
+    vector<int> stopOn;         //the stopOn metrics, numbered in the order listed above
+};
+
+//Where a workload comes from: a file (see readInWorkload) or, without a path, a random workload
+//of generateProcs processes made from seed (see "generate" above)
+struct WorkloadSource
+{
+    string path;
+    int generateProcs;
+    long long seed;
+
+    //name of the workload in the results
+    string name() const;
+
+    //loads the workload; terminates like readInWorkload if the file can't be read
+    void load(vector<Process>& procList) const;
+};
+
+//One simulation of an experiment: a workload (index into the experiment's workload sources) and
+//the scheduler and parameters to run it with
+struct ExperimentRun
+{
+    int workload;
+    int policy;
+    int quantum;
+    int highQuantum;
+    int lowQuantum;
+    double switchCost;
+    double switchCostPerWorkingSet;
+};
+
+//What a run measured
+struct RunResult
+{
+    int lastTime;
+    double avgTurnaround;
+    double avgNormalizedTurnaround;
+    double avgCpuWait;
+    double avgIoTime;
+    int turnaround90;   //turnaround time tails (nearest rank)
+    int turnaround99;
+    int maxTurnaround;
+    long long switches;
+    double switchOverhead;
+    long long runtimeUs;
+    double deadlineMissRatio;   //of the processes with deadlines, 0 if none has one (see DeadlineStats)
+    double meanTardiness;
+    int tardiness90;
+    int tardiness99;
+    int maxTardiness;
+};
+
+//Writes the results of an experiment as CSV to the spec's sinks. Results can come in any order;
+//each is written as soon as every run before it has been written, so the output is in run order
+//and streams as the runs complete.
+class ResultWriter
+{
+public:
+    ResultWriter() : sources(nullptr), runs(nullptr), written(0) {}
+
+    //opens the sinks and writes the header; returns false and sets error if a sink can't be opened
+    bool open(const ExperimentSpec& spec, const vector<WorkloadSource>& sources, const vector<ExperimentRun>& runs, string& error);
+
+    //records the result of run i, or its failure if result is null
+    void add(size_t i, const RunResult* result);
+
+private:
+    void writeRow(size_t i);
+
+    const vector<WorkloadSource>* sources;
+    const vector<ExperimentRun>* runs;
+    vector<RunResult> results;
+    vector<char> state;     //per run: 0 pending, 1 done, 2 failed
+    size_t written;         //runs written so far
+    vector<unique_ptr<ofstream>> files;
+    vector<ostream*> sinks;
+};
+
+//the spec's workloads, in result order
+vector<WorkloadSource> workloadSources(const ExperimentSpec& spec);
+
+//every run of the spec on numWorkloads workloads, in result order
+vector<ExperimentRun> expandRuns(const ExperimentSpec& spec, int numWorkloads);
+
+//simulates run on its own copy of workload
+RunResult simulateRun(bool slices, const ExperimentRun& run, const vector<Process>& workload);
+
+//fills in the measurements of a finished run but its runtime, given its last simulated time
+void summarizeRun(const vector<Process>& procList, const SwitchModel& switches, RunResult& result);
+
+//Reads an experiment spec, filling in the defaults. Returns false and sets error if the file
+//can't be read or is invalid.
+bool readExperimentSpec(const string& fname, ExperimentSpec& spec, string& error);
+
+//Runs every simulation in the spec and writes the results. Returns false and sets error if a
+//sink can't be opened.
+bool runExperiment(const ExperimentSpec& spec, string& error);
+
+//Runs every scheduler on one workload at once, each on its own thread with its own copy of
+//the process records, and prints a table comparing their mean and tail metrics
+void comparePolicies(const vector<Process>& workload, int timeQuantum, int highQuantum, int lowQuantum,
+                     double switchCost, double switchCostPerWorkingSet, bool slices);
+
+#endif
@@ -0,0 +1,25 @@
+#include<cstdio> // sscanf
+#include "fairShare.h"
+
+bool FairShareConfig::parse(const string& text, string& error)
+{
+    weights.clear();
+    size_t begin = 0;
+    while(begin < text.size())
+    {
+        size_t comma = text.find(',', begin);
+        string share = text.substr(begin, comma == string::npos ? string::npos : comma - begin);
+        int group, weight;
+        char extra;
+        if(sscanf(share.c_str(), "%d:%d%c", &group, &weight, &extra) != 2 || group < 0 || weight < 1)
+        {
+            error = "invalid group share \"" + share + "\" in \"" + text + "\"";
+            return false;
+        }
+        weights[group] = weight;
+        if(comma == string::npos)
+            break;
+        begin = comma + 1;
+    }
+    return true;
+}
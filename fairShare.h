@@ -0,0 +1,220 @@
+#ifndef FAIRSHARE_H
+#define FAIRSHARE_H
+
+#include<string>
+#include<unordered_map>
+#include "simulator.h"
+
+//How the processor is shared between the groups (tenants) of a workload (see processGroup())
+struct FairShareConfig
+{
+    unordered_map<int, int> weights;    //share of each group, relative to the others; 1 if not given
+    int groupSlice = 8;                 //time steps a group runs before the next group can take over
+
+    int weight(int group) const
+    {
+        auto it = weights.find(group);
+        return it == weights.end() ? 1 : it->second;
+    }
+
+    //parses "<group>:<weight>,..." (empty for equal shares); returns false and sets error if it isn't one
+    bool parse(const string& text, string& error);
+};
+
+//Hierarchical fair share: the processor goes to a group, and within the group to the process the
+//group's own copy of Inner picks. Groups are picked by stride scheduling: each group's virtual
+//time grows by the time it ran divided by its weight, and the group with the least virtual time
+//among those with a runnable process runs next, for up to groupSlice steps, so over a busy period
+//each group gets its weighted share whatever the others submit. The groups waiting for the
+//processor are a heap on virtual time, so picking one is O(log G) in the number of groups. A
+//group that becomes runnable starts at no less than the least virtual time of the runnable groups,
+//so time it spent idle isn't banked against the others.
+//A group's policy runs on a clock of its own, which stands still while other groups run, so its
+//quanta and waits only count the time the group had the processor. A group switch happens at the
+//end of a group slice, or when the group has nothing left to run; an arrival in another group
+//doesn't preempt, but slices end at arrivals so the schedule doesn't depend on the engine.
+template<class Inner>
+class GroupFairShareScheduler
+{
+public:
+    GroupFairShareScheduler(const Inner& prototype, const FairShareConfig& config)
+        : prototype(prototype), config(config), current(-1), sliceLeft(0), lastIdx(-1), stopped(false), lastDecision(0), busy(0), minVtime(0) {}
+
+    void admit(int idx, int curTime, vector<Process>& procList)
+    {
+        charge(curTime, procList);
+        int g = groupIndex(processGroup(procList[idx]));
+        Group& group = groups[g];
+        procList[idx].readyTime -= offset(group);
+        group.policy.admit(idx, curTime - offset(group), procList);
+        //the process that ran last woke up before its blocking was noticed
+        if(idx == lastIdx)
+        {
+            lastIdx = -1;
+            return;
+        }
+        if(group.active++ == 0 && g != current)
+        {
+            group.vtime = max(group.vtime, minVtime);
+            waiting.push(make_pair(group.vtime, g));
+        }
+    }
+
+    int next(int curTime, vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, vector<Process>& procList)
+    {
+        charge(curTime, procList);
+        if(current >= 0 && (groups[current].active == 0 || sliceLeft <= 0))
+        {
+            //Without the other groups the policy would see the process that ran block or complete
+            //at this decision, and drop it before it wakes up and is admitted again; asked only
+            //once the group runs again it would hold the process twice
+            if(stopped)
+                ask(groups[current], curTime, nextArrival, procList);
+            if(groups[current].active > 0)
+                waiting.push(make_pair(groups[current].vtime, current));
+            current = -1;
+        }
+        Slice slice = idleSlice(curTime, nextArrival);
+        while(true)
+        {
+            if(current < 0)
+            {
+                if(waiting.empty())
+                    break;
+                current = waiting.top().second;
+                waiting.pop();
+                minVtime = max(minVtime, groups[current].vtime);
+                sliceLeft = config.groupSlice;
+            }
+            Slice inner = ask(groups[current], curTime, nextArrival, procList);
+            if(inner.idx >= 0)
+            {
+                slice.idx = inner.idx;
+                slice.length = min(inner.length, sliceLeft);
+                slice.preemptAt = min(inner.preemptAt, nextArrival);
+                break;
+            }
+            //the group's policy has nothing for now; it is asked again at the next decision
+            skipped.push_back(current);
+            current = -1;
+        }
+        for(int g: skipped)
+            waiting.push(make_pair(groups[g].vtime, g));
+        skipped.clear();
+        stopped = false;
+        lastIdx = slice.idx >= 0 && isRunnable(procList[slice.idx]) ? slice.idx : -1;
+        return slice;
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        //the prototype has the levels of every group, all empty
+        long long levels[8];
+        int count = prototype.readyLengths(lengths);
+        for(const Group& group: groups)
+        {
+            group.policy.readyLengths(levels);
+            for(int k = 0; k < count; ++k)
+                lengths[k] += levels[k];
+        }
+        return count;
+    }
+
+private:
+    //stride of a group of weight 1
+    static const long long STRIDE = 1 << 20;
+
+    struct Group
+    {
+        Inner policy;
+        long long stride;   //virtual time per time step run
+        long long vtime;    //virtual time
+        long long used;     //time steps run
+        int active;         //runnable processes admitted to the group
+    };
+
+    //how far the group's clock is behind the scheduler's: the time the other groups ran
+    long long offset(const Group& group) const { return busy - group.used; }
+
+    //the group's policy's decision at curTime, on the scheduler's clock
+    Slice ask(Group& group, int curTime, int nextArrival, vector<Process>& procList)
+    {
+        long long shift = offset(group);
+        Slice inner = group.policy.nextSlice(curTime - shift, nextArrival == NEVER ? NEVER : nextArrival - shift, procList);
+        if(inner.preemptAt != NEVER)
+            inner.preemptAt += shift;
+        return inner;
+    }
+
+    //index of group id in groups, adding it the first time it is seen
+    int groupIndex(int id)
+    {
+        auto it = index.find(id);
+        if(it != index.end())
+            return it->second;
+        int g = groups.size();
+        index.emplace(id, g);
+        groups.push_back(Group{prototype, STRIDE / max(config.weight(id), 1), 0, 0, 0});
+        return g;
+    }
+
+    //charges the time since the last decision to the group that ran (the current one), and notices
+    //whether the process that ran stopped being runnable
+    void charge(int curTime, const vector<Process>& procList)
+    {
+        int elapsed = curTime - lastDecision;
+        lastDecision = curTime;
+        if(current >= 0 && elapsed > 0)
+        {
+            Group& group = groups[current];
+            group.used += elapsed;
+            group.vtime += elapsed * group.stride;
+            busy += elapsed;
+            sliceLeft -= elapsed;
+        }
+        if(lastIdx >= 0 && !isRunnable(procList[lastIdx]))
+        {
+            --groups[current].active;
+            lastIdx = -1;
+            stopped = true;
+        }
+    }
+
+    Inner prototype;
+    FairShareConfig config;
+    vector<Group> groups;
+    unordered_map<int, int> index;      //group id to its index in groups
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> waiting;
+                                        //virtual time and index of the runnable groups but the current one
+    vector<int> skipped;                //groups whose policy had nothing to run at this decision
+    int current;                        //group holding the processor, -1 for none
+    int sliceLeft;                      //time left in its group slice
+    int lastIdx;                        //process the last decision ran, -1 if none or once it is settled
+    bool stopped;                       //whether it blocked or completed since the last decision
+    int lastDecision;                   //time of the last decision
+    long long busy;                     //time steps any group ran
+    long long minVtime;                    //least virtual time a group can start from
+};
+
+//withScheduler() with the scheduler wrapped in GroupFairShareScheduler when config isn't null
+template<class F>
+bool withFairShare(int schedChoice, int timeQuantum, int highQuantum, int lowQuantum, const FairShareConfig* config, F&& f)
+{
+    return withScheduler(schedChoice, timeQuantum, highQuantum, lowQuantum, [&](auto& sched)
+    {
+        if(!config)
+        {
+            f(sched);
+            return;
+        }
+        GroupFairShareScheduler<decay_t<decltype(sched)>> fair(sched, *config);
+        f(fair);
+    });
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef IDARENA_H
+#define IDARENA_H
+
+#include<vector>
+#include<string>
+#include<string_view>
+#include<cstdint>
+#include<functional> // hash
+
+using namespace std;
+
+//handle of an interned string
+typedef uint32_t StringHandle;
+
+//Strings interned into one contiguous arena and referred to by 32 bit handles. Each distinct
+//string is stored once; the lookup table is open addressed and holds only handles, so an
+//interned string costs its characters plus about 12 bytes. Handle 0 is the empty string.
+//Interning isn't thread safe; looking strings up is.
+class StringArena
+{
+public:
+    StringArena() : slots(16, 0)
+    {
+        offsets.push_back(0);
+        intern(string_view());
+    }
+
+    //returns the handle of s, adding it on first sight
+    StringHandle intern(string_view s)
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = hash<string_view>()(s) & mask;
+        for(; slots[i] != 0; i = (i + 1) & mask)
+            if((*this)[slots[i] - 1] == s)
+                return slots[i] - 1;
+
+        StringHandle h = offsets.size() - 1;
+        chars.insert(chars.end(), s.begin(), s.end());
+        offsets.push_back(chars.size());
+        slots[i] = h + 1;
+        if(2 * size() > slots.size())
+            grow();
+        return h;
+    }
+
+    string_view operator[](StringHandle h) const
+    {
+        return string_view(chars.data() + offsets[h], offsets[h + 1] - offsets[h]);
+    }
+
+    //number of distinct strings
+    size_t size() const { return offsets.size() - 1; }
+
+private:
+    //doubles the lookup table and reinserts every handle
+    void grow()
+    {
+        vector<uint32_t> old(slots.size() * 2, 0);
+        old.swap(slots);
+        size_t mask = slots.size() - 1;
+        for(StringHandle h = 0; h < size(); ++h)
+        {
+            size_t i = hash<string_view>()((*this)[h]) & mask;
+            while(slots[i] != 0)
+                i = (i + 1) & mask;
+            slots[i] = h + 1;
+        }
+    }
+
+    vector<char> chars;         //the strings, back to back
+    vector<uint32_t> offsets;   //start of each string in chars, plus the end of the last one
+    vector<uint32_t> slots;     //hash table of handle + 1, 0 for an empty slot
+};
+
+//the arena holding every process id
+inline StringArena& processIds()
+{
+    static StringArena ids;
+    return ids;
+}
+
+#endif
@@ -0,0 +1,225 @@
+#include<chrono>   // run times
+#include<iomanip>  // setw
+#include<cmath>    // fabs
+#include "incremental.h"
+#include "traceImport.h"
+
+using namespace std::chrono;
+
+//whether the processes have the same times, priority, bursts, working set, deadline and group
+static bool sameWork(const Process& a, const Process& b)
+{
+    if(a.startTime != b.startTime || a.totalTimeNeeded != b.totalTimeNeeded || a.priority != b.priority
+       || relativeDeadline(a) != relativeDeadline(b) || processGroup(a) != processGroup(b)
+       || estimateScale(a) != estimateScale(b))
+        return false;
+    if(!a.extras || !b.extras)
+        return a.extras == b.extras;
+    //the working set, then the bursts up to their end marker
+    const vector<int>& pool = burstPool();
+    uint32_t i = a.extras, j = b.extras;
+    if(pool[i] != pool[j])
+        return false;
+    for(++i, ++j; pool[i] == pool[j]; ++i, ++j)
+        if(pool[i] == END_OF_BURSTS)
+            return true;
+    return false;
+}
+
+int earliestChange(const vector<Process>& workload, const vector<Process>& changed)
+{
+    int earliest = NEVER;
+    size_t common = min(workload.size(), changed.size());
+    for(size_t i = 0; i < common; ++i)
+        if(!sameWork(workload[i], changed[i]))
+            earliest = min(earliest, min(workload[i].startTime, changed[i].startTime));
+    for(size_t i = common; i < workload.size(); ++i)
+        earliest = min(earliest, workload[i].startTime);
+    for(size_t i = common; i < changed.size(); ++i)
+        earliest = min(earliest, changed[i].startTime);
+    return earliest;
+}
+
+template<class Policy>
+class CheckpointedSimulation : public IncrementalSimulation
+{
+public:
+    CheckpointedSimulation(const Policy& policy, double switchCost, double switchCostPerWorkingSet)
+        : initial(policy), switchCost(switchCost), switchCostPerWorkingSet(switchCostPerWorkingSet), interval(0), nextCheckpoint(0) {}
+
+    RunResult run(const vector<Process>& workload) override
+    {
+        auto start = high_resolution_clock::now();
+        procList = workload;
+        for(auto& p: procList)
+            resetBursts(p);
+        checkpoints.clear();
+        interval = max(CHECKPOINT_INTERVAL, static_cast<long long>(procList.size() / 8));
+        nextCheckpoint = 0;
+
+        Policy policy = initial;
+        SwitchModel switches(switchCost, switchCostPerWorkingSet);
+        SliceLoopState state;
+        TimerWheel blocked;
+        result = finish(policy, switches, state, blocked);
+        result.runtimeUs = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        return result;
+    }
+
+    WhatIfResult whatIf(const vector<Process>& changed) override
+    {
+        WhatIfResult w = {result, result, earliestChange(procList, changed), result.lastTime};
+        if(w.changedAt == NEVER)
+        {
+            w.after.runtimeUs = 0;
+            return w;
+        }
+
+        if(checkpoints.empty())
+        {
+            w.after = run(changed);
+            w.resumedAt = 0;
+            return w;
+        }
+
+        auto start = high_resolution_clock::now();
+        size_t k = checkpoints.size() - 1;
+        while(checkpoints[k].state.curTime > w.changedAt)
+            --k;
+        Checkpoint c = checkpoints[k];
+        checkpoints.erase(checkpoints.begin() + k, checkpoints.end());
+        nextCheckpoint = c.state.decisions;
+        w.resumedAt = c.state.curTime;
+
+        //processes that completed by the checkpoint are as the run left them, the others in
+        //flight are in the checkpoint and the rest haven't arrived yet
+        vector<Process> resumed = changed;
+        for(size_t i = 0; i < resumed.size(); ++i)
+        {
+            StringHandle id = resumed[i].id;
+            if(i < procList.size() && procList[i].isDone && procList[i].timeFinished < c.state.curTime)
+                resumed[i] = procList[i];
+            else
+                resetBursts(resumed[i]);
+            resumed[i].id = id;
+        }
+        for(auto& entry: c.inFlight)
+        {
+            StringHandle id = resumed[entry.first].id;
+            resumed[entry.first] = entry.second;
+            resumed[entry.first].id = id;
+        }
+        procList.swap(resumed);
+
+        TimerWheel blocked;
+        blocked.restore(c.blocked);
+        result = finish(c.policy, c.switches, c.state, blocked);
+        result.runtimeUs = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        w.after = result;
+        return w;
+    }
+
+private:
+    struct Checkpoint
+    {
+        SliceLoopState state;
+        TimerWheel::Saved blocked;
+        Policy policy;
+        SwitchModel switches;
+        vector<pair<int, Process>> inFlight;  //admitted processes not completed yet
+    };
+
+    //runs the slice loop from the given point to the end, taking checkpoints
+    RunResult finish(Policy& policy, SwitchModel& switches, SliceLoopState& state, TimerWheel& blocked)
+    {
+        vector<int> order = arrivalOrder(procList);
+        auto observer = [&](const SliceLoopState& s, const TimerWheel& wheel, const Policy& p, const SwitchModel& sw, const vector<Process>& procs)
+        {
+            if(s.decisions < nextCheckpoint)
+                return;
+            checkpoints.push_back(Checkpoint{s, TimerWheel::Saved(), p, sw, {}});
+            Checkpoint& c = checkpoints.back();
+            wheel.save(c.blocked);
+            for(unsigned int i = 0; i < s.arrived; ++i)
+                if(!procs[order[i]].isDone)
+                    c.inFlight.emplace_back(order[i], procs[order[i]]);
+            if(checkpoints.size() > MAX_CHECKPOINTS)
+            {
+                for(size_t i = 1; 2 * i < checkpoints.size(); ++i)
+                    checkpoints[i] = move(checkpoints[2 * i]);
+                checkpoints.erase(checkpoints.begin() + (checkpoints.size() + 1) / 2, checkpoints.end());
+                interval *= 2;
+            }
+            nextCheckpoint = checkpoints.back().state.decisions + interval;
+        };
+
+        RunResult r = {};
+        r.lastTime = continueSlices(policy, procList, order, state, blocked, switches, nullptr, nullptr, observer);
+        summarizeRun(procList, switches, r);
+        return r;
+    }
+
+    Policy initial;                 //the scheduler before any process arrived
+    double switchCost;
+    double switchCostPerWorkingSet;
+    vector<Process> procList;       //the workload simulated last, as the run left it
+    RunResult result;               //its run statistics
+    vector<Checkpoint> checkpoints; //in time order; the first is at time 0
+    long long interval;             //decisions between checkpoints
+    long long nextCheckpoint;       //decision count at which the next checkpoint is taken
+};
+
+unique_ptr<IncrementalSimulation> makeIncrementalSimulation(int schedChoice, int timeQuantum, int highQuantum, int lowQuantum,
+                                                            double switchCost, double switchCostPerWorkingSet)
+{
+    unique_ptr<IncrementalSimulation> simulation;
+    withScheduler(schedChoice, timeQuantum, highQuantum, lowQuantum, [&](auto& sched)
+    {
+        typedef typename decay<decltype(sched)>::type Policy;
+        simulation.reset(new CheckpointedSimulation<Policy>(sched, switchCost, switchCostPerWorkingSet));
+    });
+    return simulation;
+}
+
+void runWhatIfs(const vector<Process>& workload, const vector<string>& paths, int schedChoice, int timeQuantum, int highQuantum,
+                int lowQuantum, double switchCost, double switchCostPerWorkingSet)
+{
+    unique_ptr<IncrementalSimulation> simulation = makeIncrementalSimulation(schedChoice, timeQuantum, highQuantum, lowQuantum,
+                                                                             switchCost, switchCostPerWorkingSet);
+    RunResult full = simulation->run(workload);
+    cout << "\n\nSimulated the workload in " << full.runtimeUs << " us\n";
+
+    for(auto& path: paths)
+    {
+        vector<Process> changed;
+        readInWorkload(path, changed);
+        WhatIfResult w = simulation->whatIf(changed);
+
+        cout << "\nWhat if \"" << path << "\":\n";
+        if(w.changedAt == NEVER)
+        {
+            cout << "No process changed\n";
+            continue;
+        }
+        cout << "First change at time " << w.changedAt << ", resumed from the checkpoint at time " << w.resumedAt
+             << ", re-simulated in " << w.after.runtimeUs << " us\n"
+             << "                    Metric |      Before |       After |       Delta |\n"
+             << string(70, '-') << "\n" << setprecision(2) << fixed;
+        auto row = [](const char* name, double before, double after)
+        {
+            //no "-0.00" for differences lost in the rounding
+            double delta = fabs(after - before) < 0.005 ? 0 : after - before;
+            cout << setw(26) << name << " |" << setw(12) << before << " |" << setw(12) << after << " |"
+                 << setw(12) << showpos << delta << noshowpos << " |\n";
+        };
+        row("Finish time", w.before.lastTime + 1, w.after.lastTime + 1);
+        row("Mean turnaround", w.before.avgTurnaround, w.after.avgTurnaround);
+        row("90th turnaround", w.before.turnaround90, w.after.turnaround90);
+        row("99th turnaround", w.before.turnaround99, w.after.turnaround99);
+        row("Max turnaround", w.before.maxTurnaround, w.after.maxTurnaround);
+        row("Mean normalized turnaround", w.before.avgNormalizedTurnaround, w.after.avgNormalizedTurnaround);
+        row("CPU wait time", w.before.avgCpuWait, w.after.avgCpuWait);
+        row("IO time", w.before.avgIoTime, w.after.avgIoTime);
+        row("Switches", w.before.switches, w.after.switches);
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include<memory>  // unique_ptr
+#include "experiment.h"
+
+//What a what-if re-simulation found
+struct WhatIfResult
+{
+    RunResult before;   //the workload simulated last
+    RunResult after;    //the changed workload; its runtime is that of the re-simulation
+    int changedAt;      //earliest time the change could matter, NEVER if nothing changed
+    int resumedAt;      //time of the checkpoint the re-simulation resumed from
+};
+
+//Incremental re-simulation for what-if analysis on large workloads. A run on the slice engine
+//keeps checkpoints of the loop state, the scheduler, the switch model, the blocked processes and
+//the records of the processes in flight (admitted and not completed). Processes that completed by
+//a checkpoint are restored from the end of the run, since nothing that decides the schedule
+//changes for a process after it completes, and those not yet admitted from the changed workload.
+//A changed workload is a version of the last one with some processes changed, added at the end
+//or removed from the end. Nothing can be scheduled differently before the earliest arrival of
+//such a process, so the run resumes from the last checkpoint before it. Checkpoints are taken
+//every CHECKPOINT_INTERVAL decisions, or every eighth of the process count if that is more so
+//the O(processes) scan a checkpoint takes stays cheap; beyond MAX_CHECKPOINTS every other one is
+//dropped and the interval doubles.
+class IncrementalSimulation
+{
+public:
+    static const long long CHECKPOINT_INTERVAL = 1 << 10;
+    static const size_t MAX_CHECKPOINTS = 64;
+
+    virtual ~IncrementalSimulation() {}
+
+    //simulates workload from scratch, keeping checkpoints along the way
+    virtual RunResult run(const vector<Process>& workload) = 0;
+
+    //Simulates changed, a version of the workload simulated last, from the last checkpoint before
+    //its first change. It becomes the workload simulated last.
+    virtual WhatIfResult whatIf(const vector<Process>& changed) = 0;
+};
+
+//the incremental simulation of scheduler schedChoice (1-8, see withScheduler()), null for an
+//unknown choice
+unique_ptr<IncrementalSimulation> makeIncrementalSimulation(int schedChoice, int timeQuantum, int highQuantum, int lowQuantum,
+                                                            double switchCost, double switchCostPerWorkingSet);
+
+//Earliest arrival of a process that is in only one of the workloads or has other times, priority,
+//bursts, working set or deadline in changed than in workload; NEVER if there is none
+int earliestChange(const vector<Process>& workload, const vector<Process>& changed);
+
+//Simulates workload, then each changed workload in paths in turn against the one before it, and
+//prints how each changed the run statistics and how long the re-simulation took
+void runWhatIfs(const vector<Process>& workload, const vector<string>& paths, int schedChoice, int timeQuantum, int highQuantum,
+                int lowQuantum, double switchCost, double switchCostPerWorkingSet);
+
+#endif
@@ -0,0 +1,104 @@
+#include<sstream>      // response text
+#include<unistd.h>     // close, unlink
+#include<poll.h>       // poll
+#include<sys/socket.h> // accept, recv, shutdown
+#include "metrics.h"
+#include "sockets.h"
+
+//how long the server waits for a connection before checking whether it should stop (ms)
+static const int POLL_MS = 200;
+
+//how long the server waits for a client's request before answering anyway (ms)
+static const int REQUEST_MS = 100;
+
+MetricsPublisher::MetricsPublisher(const string& address)
+    : steps(0), histogram(), lastPublish(chrono::steady_clock::now()), lastSimTime(0), sequence(0), stopping(false), listenFd(-1)
+{
+    MetricsSnapshot empty = {};
+    store(empty);
+
+    //a TCP address without a host only listens on localhost
+    listenFd = listenOn(address, "127.0.0.1", socketPath, listenError);
+    if(listenFd >= 0)
+        server = thread(&MetricsPublisher::serve, this);
+}
+
+MetricsPublisher::~MetricsPublisher()
+{
+    stopping.store(true);
+    //wakes the server thread up from poll
+    if(listenFd >= 0)
+        shutdown(listenFd, SHUT_RDWR);
+    if(server.joinable())
+        server.join();
+    if(listenFd >= 0)
+        close(listenFd);
+    if(!socketPath.empty())
+        unlink(socketPath.c_str());
+}
+
+MetricsSnapshot MetricsPublisher::read() const
+{
+    long long words[WORDS];
+    unsigned int before, after;
+    do
+    {
+        before = sequence.load(memory_order_acquire);
+        for(int i = 0; i < WORDS; ++i)
+            words[i] = data[i].load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = sequence.load(memory_order_relaxed);
+    } while(before != after || (before & 1));
+
+    MetricsSnapshot s;
+    memcpy(&s, words, sizeof(s));
+    return s;
+}
+
+//the snapshot as "name value" lines
+static string formatSnapshot(const MetricsSnapshot& s)
+{
+    ostringstream out;
+    out << "sim_time " << s.simTime << "\n"
+        << "steps_per_sec " << s.stepsPerSec << "\n"
+        << "processes " << s.processes << "\n"
+        << "completed " << s.completed << "\n"
+        << "blocked " << s.blocked << "\n";
+    for(int i = 0; i < s.levels && i < MAX_READY_LEVELS; ++i)
+        out << "ready_queue{level=\"" << i << "\"} " << s.ready[i] << "\n";
+    out << "turnaround{quantile=\"0.5\"} " << s.turnaround50 << "\n"
+        << "turnaround{quantile=\"0.9\"} " << s.turnaround90 << "\n"
+        << "turnaround{quantile=\"0.99\"} " << s.turnaround99 << "\n"
+        << "done " << s.done << "\n";
+    return out.str();
+}
+
+void MetricsPublisher::serve()
+{
+    pollfd listening = {listenFd, POLLIN, 0};
+    while(!stopping.load())
+    {
+        if(poll(&listening, 1, POLL_MS) <= 0)
+            continue;
+        int client = accept(listenFd, nullptr, nullptr);
+        if(client < 0)
+            continue;
+
+        //an HTTP client sends a request first; a plain client may send nothing
+        char request[1024];
+        ssize_t got = 0;
+        pollfd reading = {client, POLLIN, 0};
+        if(poll(&reading, 1, REQUEST_MS) > 0)
+            got = recv(client, request, sizeof(request), 0);
+
+        string body = formatSnapshot(read());
+        string response;
+        if(got >= 3 && string(request, 3) == "GET")
+            response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " + to_string(body.size())
+                       + "\r\nConnection: close\r\n\r\n" + body;
+        else
+            response = body;
+        sendAll(client, response);
+        close(client);
+    }
+}
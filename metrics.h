@@ -0,0 +1,138 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include<atomic>  // seqlock
+#include<thread>  // server thread
+#include<chrono>  // publish times
+#include<cstring> // memcpy
+#include<string>
+#include "policies.h"
+#include "stats.h"
+
+using namespace std;
+
+//the most ready queue levels a snapshot reports
+const int MAX_READY_LEVELS = 4;
+
+//State of a running simulation as published for monitoring. Every field is a long long so the
+//snapshot can be copied word by word through the seqlock.
+struct MetricsSnapshot
+{
+    long long simTime;      //current simulated time
+    long long stepsPerSec;  //simulated time steps per wall clock second since the previous snapshot
+    long long processes;    //number of processes in the workload
+    long long completed;    //number of processes completed so far
+    long long blocked;      //number of processes blocked on IO
+    long long levels;       //number of ready queue levels of the policy
+    long long ready[MAX_READY_LEVELS];  //processes in each ready queue level
+    long long turnaround50; //running turnaround percentiles of the completed processes
+    long long turnaround90;
+    long long turnaround99;
+    long long done;         //1 once the simulation has finished
+};
+
+//Live metrics for long simulations. Every CHECK_INTERVAL loop iterations the engine looks at the
+//clock, and at most every PUBLISH_PERIOD it publishes a snapshot into a seqlock. A background
+//thread serves the latest snapshot as text to every client connecting to a Unix domain socket or
+//to a localhost TCP port (answering HTTP requests with an HTTP response, so curl works for both). The engine never waits on the server: a publish
+//is a handful of relaxed stores, and the server retries a read that overlapped one.
+//Turnaround percentiles come from a histogram (see stats.h), so they are accurate to within 25%.
+class MetricsPublisher
+{
+public:
+    static const long long CHECK_INTERVAL = 1 << 6;
+    static constexpr chrono::milliseconds PUBLISH_PERIOD = chrono::milliseconds(100);
+
+    //Starts serving on address: ":<port>" for localhost TCP, otherwise a socket path.
+    //Check ok() for whether the server could be started, and error() for why not.
+    explicit MetricsPublisher(const string& address);
+    ~MetricsPublisher();
+
+    bool ok() const { return listenFd >= 0; }
+    const string& error() const { return listenError; }
+
+    //engine side: counts a loop iteration, returns true when it is time to check the clock
+    bool tick() { return (++steps & (CHECK_INTERVAL - 1)) == 0; }
+
+    //engine side: records a completed process's turnaround time
+    void complete(int turnaround) { ++histogram[histogramBucket(turnaround)]; }
+
+    //engine side: publishes the state of the simulation if the last snapshot is older than
+    //PUBLISH_PERIOD or the simulation is done
+    template<class Policy>
+    void publish(int simTime, int completed, int processes, int blocked, const Policy& policy, bool done = false)
+    {
+        auto now = chrono::steady_clock::now();
+        if(!done && now - lastPublish < PUBLISH_PERIOD)
+            return;
+
+        MetricsSnapshot s = {};
+        s.simTime = simTime;
+        s.processes = processes;
+        s.completed = completed;
+        s.blocked = blocked;
+        s.levels = policy.readyLengths(s.ready);
+        s.turnaround50 = percentile(50, completed);
+        s.turnaround90 = percentile(90, completed);
+        s.turnaround99 = percentile(99, completed);
+        s.done = done;
+
+        double seconds = chrono::duration<double>(now - lastPublish).count();
+        s.stepsPerSec = seconds > 0 ? static_cast<long long>((simTime - lastSimTime) / seconds) : 0;
+        lastPublish = now;
+        lastSimTime = simTime;
+        store(s);
+    }
+
+    //server side: the latest snapshot
+    MetricsSnapshot read() const;
+
+private:
+    static const int WORDS = sizeof(MetricsSnapshot) / sizeof(long long);
+
+    //turnaround time below which pct percent of the count completed processes fall
+    long long percentile(int pct, long long count) const
+    {
+        if(count == 0)
+            return 0;
+        long long rank = (count * pct + 99) / 100, seen = 0;
+        for(int b = 0; b < HISTOGRAM_BUCKETS; ++b)
+            if((seen += histogram[b]) >= rank)
+                return histogramBucketTop(b);
+        return histogramBucketTop(HISTOGRAM_BUCKETS - 1);
+    }
+
+    //seqlock write; there is only ever one writer
+    void store(const MetricsSnapshot& s)
+    {
+        long long words[WORDS];
+        memcpy(words, &s, sizeof(s));
+        unsigned int v = sequence.load(memory_order_relaxed);
+        sequence.store(v + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for(int i = 0; i < WORDS; ++i)
+            data[i].store(words[i], memory_order_relaxed);
+        sequence.store(v + 2, memory_order_release);
+    }
+
+    //server thread: answers clients until stopping is set
+    void serve();
+
+    //engine side state
+    long long steps;                //loop iterations so far
+    long long histogram[HISTOGRAM_BUCKETS];   //turnaround times of the completed processes
+    chrono::steady_clock::time_point lastPublish;
+    long long lastSimTime;
+
+    //shared with the server thread
+    atomic<unsigned int> sequence;  //odd while a snapshot is being written
+    atomic<long long> data[WORDS];  //the snapshot
+    atomic<bool> stopping;
+
+    string socketPath;  //path to unlink on exit, empty for TCP
+    string listenError; //why the server couldn't be started
+    int listenFd;
+    thread server;
+};
+
+#endif
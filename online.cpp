@@ -0,0 +1,277 @@
+#include<cstdio>       // sscanf
+#include<cstring>      // memcpy
+#include<functional>   // producer bodies
+#include<random>       // generated arrivals
+#include<sstream>      // process list lines
+#include<algorithm>    // copy
+#include<unistd.h>     // close, unlink
+#include<sys/socket.h> // accept
+#include "online.h"
+#include "sockets.h"
+
+static void setName(Arrival& a, string_view name)
+{
+    size_t length = min(name.size(), static_cast<size_t>(Arrival::MAX_NAME));
+    memcpy(a.name, name.data(), length);
+    a.name[length] = '\0';
+}
+
+bool toArrival(const Process& p, Arrival& a)
+{
+    setName(a, processName(p));
+    a.startTime = p.startTime;
+    a.totalTimeNeeded = p.totalTimeNeeded;
+    a.priority = p.priority;
+    a.workingSet = workingSet(p);
+    a.deadline = relativeDeadline(p);
+    a.group = processGroup(p);
+    a.numBursts = 0;
+    if(p.extras)
+        for(uint32_t i = p.extras + 1; burstPool()[i] != END_OF_BURSTS; ++i)
+        {
+            if(a.numBursts == Arrival::MAX_BURSTS)
+                return false;
+            a.bursts[a.numBursts++] = burstPool()[i];
+        }
+    return true;
+}
+
+bool parseArrival(const string& line, Arrival& a)
+{
+    istringstream in(line);
+    string name, rest;
+    if(!(in >> name >> a.startTime >> a.totalTimeNeeded >> a.priority))
+        return false;
+    getline(in, rest);
+    vector<int> bursts;
+    a.workingSet = 0;
+    a.deadline = 0;
+    a.group = 0;
+    readBurstColumns(rest, a.totalTimeNeeded, a.workingSet, a.deadline, a.group, bursts);
+    if(bursts.size() > static_cast<size_t>(Arrival::MAX_BURSTS))
+        return false;
+    setName(a, name);
+    a.numBursts = bursts.size();
+    copy(bursts.begin(), bursts.end(), a.bursts);
+    return true;
+}
+
+OnlineAdmission::OnlineAdmission(bool dropWhenFull, size_t capacity) : ring(capacity), dropWhenFull(dropWhenFull) {}
+
+int OnlineAdmission::addProducer()
+{
+    producers.emplace_back(new Producer);
+    return producers.size() - 1;
+}
+
+bool OnlineAdmission::push(int producer, const Arrival& a)
+{
+    Producer& p = *producers[producer];
+    int watermark = p.watermark.load(memory_order_relaxed);
+    if(a.startTime < watermark)
+        p.late.fetch_add(1, memory_order_relaxed);
+    Arrival stamped = a;
+    stamped.producer = producer;
+    stamped.sequence = p.sequence++;
+    bool pushed = ring.tryPush(stamped);
+    if(!pushed && !dropWhenFull)
+    {
+        p.stalls.fetch_add(1, memory_order_relaxed);
+        while(!(pushed = ring.tryPush(stamped)))
+            this_thread::yield();
+    }
+    (pushed ? p.pushed : p.dropped).fetch_add(1, memory_order_relaxed);
+    //published after the arrival, so the engine sees it once it sees the watermark
+    if(a.startTime > watermark)
+        p.watermark.store(a.startTime, memory_order_release);
+    return pushed;
+}
+
+void OnlineAdmission::advance(int producer, int time)
+{
+    Producer& p = *producers[producer];
+    if(time > p.watermark.load(memory_order_relaxed))
+        p.watermark.store(time, memory_order_release);
+}
+
+void OnlineAdmission::close(int producer)
+{
+    producers[producer]->watermark.store(NEVER, memory_order_release);
+}
+
+int OnlineAdmission::horizon() const
+{
+    int lowest = NEVER;
+    for(auto& p: producers)
+        lowest = min(lowest, p->watermark.load(memory_order_acquire));
+    return lowest;
+}
+
+long long OnlineAdmission::pushed() const
+{
+    long long total = 0;
+    for(auto& p: producers)
+        total += p->pushed.load(memory_order_relaxed);
+    return total;
+}
+
+long long OnlineAdmission::dropped() const
+{
+    long long total = 0;
+    for(auto& p: producers)
+        total += p->dropped.load(memory_order_relaxed);
+    return total;
+}
+
+long long OnlineAdmission::stalls() const
+{
+    long long total = 0;
+    for(auto& p: producers)
+        total += p->stalls.load(memory_order_relaxed);
+    return total;
+}
+
+long long OnlineAdmission::late() const
+{
+    long long total = 0;
+    for(auto& p: producers)
+        total += p->late.load(memory_order_relaxed);
+    return total;
+}
+
+//random arrivals made like the generated experiment workloads, a quarter of them with an IO burst
+static void generateArrivals(OnlineAdmission& admission, int producer, int count, unsigned int seed, const string& prefix)
+{
+    mt19937 random(seed);
+    Arrival a;
+    a.startTime = 0;
+    a.workingSet = 0;
+    a.deadline = 0;
+    a.group = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        setName(a, prefix + to_string(i + 1));
+        a.startTime += random() % 3;
+        a.totalTimeNeeded = random() % 10 + 1;
+        a.priority = random() % 2;
+        a.numBursts = 0;
+        if(random() % 4 == 0)
+        {
+            a.bursts[0] = random() % 5 + 1;
+            a.bursts[1] = random() % 10 + 1;
+            a.bursts[2] = random() % 5 + 1;
+            a.numBursts = 3;
+            a.totalTimeNeeded = a.bursts[0] + a.bursts[2];
+        }
+        admission.push(producer, a);
+    }
+    admission.close(producer);
+}
+
+static void listenForArrivals(OnlineAdmission& admission, int producer, int listenFd, string socketPath)
+{
+    int fd = accept(listenFd, nullptr, nullptr);
+    ::close(listenFd);
+    if(!socketPath.empty())
+        unlink(socketPath.c_str());
+    string buffer, line;
+    Arrival a;
+    while(fd >= 0 && readLine(fd, buffer, line))
+        if(parseArrival(line, a))
+            admission.push(producer, a);
+    if(fd >= 0)
+        ::close(fd);
+    admission.close(producer);
+}
+
+bool startProducers(OnlineAdmission& admission, const vector<Process>& workload, const vector<string>& feeds,
+                    vector<thread>& threads, string& error)
+{
+    //every feed is checked before any producer starts, so a bad one leaves nothing running
+    vector<function<void()>> producers;
+    vector<int> listenFds;
+    for(size_t f = 0; f < feeds.size() && error.empty(); ++f)
+    {
+        const string& feed = feeds[f];
+        int producer = admission.addProducer();
+        if(feed.empty())
+        {
+            //converted here, on the thread that owns the id arena and the burst pool
+            vector<Arrival> arrivals;
+            for(int idx: arrivalOrder(workload))
+            {
+                Arrival a;
+                if(!toArrival(workload[idx], a))
+                    error = "Process \"" + string(processName(workload[idx])) + "\" has too many bursts to stream";
+                arrivals.push_back(a);
+            }
+            producers.push_back([&admission, producer, arrivals]()
+            {
+                for(auto& a: arrivals)
+                    admission.push(producer, a);
+                admission.close(producer);
+            });
+        }
+        else if(feed.compare(0, 9, "generate:") == 0)
+        {
+            int count = 0;
+            unsigned int seed = f;
+            if(sscanf(feed.c_str() + 9, "%d,%u", &count, &seed) < 1 || count < 0)
+                error = "Invalid feed \"" + feed + "\"";
+            string prefix = "g" + to_string(f) + "-";
+            producers.push_back([&admission, producer, count, seed, prefix]() { generateArrivals(admission, producer, count, seed, prefix); });
+        }
+        else if(feed.compare(0, 7, "listen:") == 0)
+        {
+            string socketPath, reason;
+            int listenFd = listenOn(feed.substr(7), "127.0.0.1", socketPath, reason);
+            if(listenFd < 0)
+                error = "Unable to listen for arrivals on \"" + feed.substr(7) + "\" (" + reason + ")";
+            listenFds.push_back(listenFd);
+            producers.push_back([&admission, producer, listenFd, socketPath]() { listenForArrivals(admission, producer, listenFd, socketPath); });
+        }
+        else
+            error = "Unknown feed \"" + feed + "\"";
+    }
+    if(!error.empty())
+    {
+        for(int fd: listenFds)
+            if(fd >= 0)
+                ::close(fd);
+        return false;
+    }
+    for(auto& run: producers)
+        threads.emplace_back(run);
+    return true;
+}
+
+void receiveArrivals(OnlineAdmission& admission, PendingArrivals& pending)
+{
+    Arrival a;
+    vector<int> bursts;
+    while(admission.pop(a))
+    {
+        Process p;
+        setProcessName(p, a.name);
+        p.startTime = a.startTime;
+        p.totalTimeNeeded = a.totalTimeNeeded;
+        p.priority = a.priority;
+        bursts.assign(a.bursts, a.bursts + a.numBursts);
+        setBursts(p, a.workingSet, bursts, a.deadline, a.group);
+        resetBursts(p);
+        pending.push(PendingArrival{a.startTime, a.producer, a.sequence, p});
+    }
+}
+
+int awaitHorizon(OnlineAdmission& admission, int curTime, PendingArrivals& pending)
+{
+    while(true)
+    {
+        //read before draining, so every arrival below it is in the ring by then
+        int horizon = admission.horizon();
+        receiveArrivals(admission, pending);
+        if(horizon > curTime)
+            return horizon;
+        this_thread::yield();
+    }
+}
@@ -0,0 +1,202 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include<thread>
+#include<queue>      // priority_queue
+#include<functional> // greater
+#include<tuple>      // tie
+#include "admissionRing.h"
+#include "simulator.h"
+
+//capacity of the ring producers push arrivals into
+const size_t ADMISSION_RING_SIZE = 1 << 12;
+
+//A process arrival as a producer pushes it. It is plain data: the id arena and the burst pool
+//aren't thread safe, so the engine thread interns the name and stores the bursts on receipt.
+struct Arrival
+{
+    static const int MAX_NAME = 31;
+    static const int MAX_BURSTS = 31;
+
+    char name[MAX_NAME + 1];   //truncated to MAX_NAME characters
+    int startTime;
+    int totalTimeNeeded;
+    int priority;
+    int workingSet;
+    int deadline;              //relative to startTime, 0 for none
+    int group;                 //0 for the default group
+    int numBursts;             //0 for a single CPU burst of totalTimeNeeded
+    int bursts[MAX_BURSTS];    //alternating CPU and IO, as setBursts() takes them
+    int producer;              //set by OnlineAdmission::push()
+    int sequence;              //arrivals the producer pushed before it, set by OnlineAdmission::push()
+};
+
+//Arrival of process p, for replaying a loaded workload. Reads the id arena and the burst pool, so
+//it runs before the producers start. Returns false if p has more than MAX_BURSTS bursts.
+bool toArrival(const Process& p, Arrival& a);
+
+//Arrival from a process list line "id start total priority [bursts] [ws=<size>] ..." (see
+//readInProcList()). Returns false for a line that isn't one or has too many bursts.
+bool parseArrival(const string& line, Arrival& a);
+
+//Online admission: producer threads push arrivals into an MpscRing and the simulation thread
+//drains it at each scheduling point (see simulateOnline()).
+//Each producer pushes its arrivals in start time order, so its last start time is a watermark:
+//nothing it pushes later arrives earlier. The engine only decides at a time below every open
+//producer's watermark, so it never misses an arrival that was due. Arrivals due at the same time
+//are admitted, and given their index in the process list, in producer order and then in the order
+//each producer pushed them, so the schedule is the one simulateSlices() gives for the resulting
+//process list however the threads interleave. An arrival
+//pushed below its producer's own watermark breaks that promise; it is counted as late and
+//admitted at the next scheduling point.
+//When the ring is full a producer either waits for the engine to drain it (back-pressure,
+//counted as a stall) or drops the arrival (counted as dropped).
+class OnlineAdmission
+{
+public:
+    explicit OnlineAdmission(bool dropWhenFull, size_t capacity = ADMISSION_RING_SIZE);
+
+    //registers a producer and returns its number; producers are all added before any starts
+    int addProducer();
+
+    //Pushes a from producer's thread, stamped with the producer and its sequence number, waiting
+    //for room or dropping it as configured. Returns false if it was dropped.
+    bool push(int producer, const Arrival& a);
+
+    //promises that producer pushes nothing arriving before time
+    void advance(int producer, int time);
+
+    //producer pushes nothing more
+    void close(int producer);
+
+    //Engine side: the lowest watermark of the open producers, NEVER once every producer is closed.
+    //Every arrival before it has been pushed.
+    int horizon() const;
+
+    //engine side: takes the next pushed arrival, false if there is none right now
+    bool pop(Arrival& a) { return ring.tryPop(a); }
+
+    //totals over the producers
+    long long pushed() const;
+    long long dropped() const;
+    long long stalls() const;
+    long long late() const;
+
+private:
+    //each producer's state on a cache line of its own, written only by that producer
+    struct alignas(64) Producer
+    {
+        atomic<int> watermark{0};
+        atomic<long long> pushed{0};
+        atomic<long long> dropped{0};
+        atomic<long long> stalls{0};
+        atomic<long long> late{0};
+        int sequence = 0;   //arrivals pushed or dropped, read only by the producer
+    };
+
+    MpscRing<Arrival> ring;
+    bool dropWhenFull;
+    vector<unique_ptr<Producer>> producers;
+};
+
+//Starts a producer thread for each feed, adding it to admission:
+//  ""                          replays workload in start time order
+//  "generate:<count>[,<seed>]" generates count random arrivals, some with IO
+//  "listen:<address>"          takes one connection on address (see sockets.h) and pushes each
+//                              process list line sent until it closes
+//Each producer closes itself when done; threads gets the producers to join. Returns false with
+//error set, starting none of them, if a feed is invalid.
+bool startProducers(OnlineAdmission& admission, const vector<Process>& workload, const vector<string>& feeds,
+                    vector<thread>& threads, string& error);
+
+//A received arrival's record, waiting for its start time. It gets its index in the process list
+//when it is admitted, so the order of the ties doesn't depend on the order they were received in.
+struct PendingArrival
+{
+    int startTime;
+    int producer;
+    int sequence;
+    Process process;
+
+    bool operator>(const PendingArrival& other) const
+    {
+        return tie(startTime, producer, sequence) > tie(other.startTime, other.producer, other.sequence);
+    }
+};
+typedef priority_queue<PendingArrival, vector<PendingArrival>, greater<PendingArrival>> PendingArrivals;
+
+//Makes a record of each arrival pushed so far and queues it in pending by start time, then
+//producer, then sequence
+void receiveArrivals(OnlineAdmission& admission, PendingArrivals& pending);
+
+//Waits until the producers are past curTime, receiving arrivals meanwhile, and returns the horizon
+int awaitHorizon(OnlineAdmission& admission, int curTime, PendingArrivals& pending);
+
+//The slice loop of simulateSlices() with the processes arriving through admission instead of
+//being known up front. procList starts empty and gains a record for each arrival as it is
+//admitted. Slices that an arrival could preempt end at the producers' horizon, where the loop
+//waits for the producers before deciding again. Runs until every producer is closed and every
+//process received has completed, and returns the last simulated time.
+template<class Policy>
+int simulateOnline(Policy& policy, OnlineAdmission& admission, vector<Process>& procList, SwitchModel& switches,
+                   MetricsPublisher* metrics = nullptr, ScheduleTimeline* timeline = nullptr)
+{
+    int curTime = 0, lastTime = 0, numDone = 0, overhead = 0;
+    TimerWheel blocked;   //processes waiting for IO
+    PendingArrivals pending;
+
+    while(true)
+    {
+        int horizon = awaitHorizon(admission, curTime, pending);
+        while(!pending.empty() && pending.top().startTime <= curTime)
+        {
+            procList.push_back(pending.top().process);
+            pending.pop();
+            admitArrival(policy, procList.size() - 1, curTime, overhead, procList);
+        }
+        wakeBlocked(policy, blocked, curTime, overhead, procList);
+        int nextWakeup = blocked.nextExpiry();
+        //the next event the loop knows of, and the earliest an arrival could come
+        int nextEvent = min(pending.empty() ? NEVER : pending.top().startTime, nextWakeup);
+        int nextArrival = min(nextEvent, horizon);
+
+        int numProc = procList.size();
+        Slice slice = policy.nextSlice(curTime - overhead, nextArrival == NEVER ? NEVER : nextArrival - overhead, procList);
+        if(slice.idx < 0 || slice.idx >= numProc)
+        {
+            if(nextArrival == NEVER)
+                break;
+            //idling up to the horizon only waits for the producers; it is not part of the run
+            if(nextEvent == nextArrival)
+                lastTime = curTime;
+            curTime = nextArrival;
+            continue;
+        }
+
+        int preemptAt = slice.preemptAt == NEVER ? NEVER : slice.preemptAt + overhead;
+        int delay = switches.dispatch(slice.idx, procList[slice.idx]);
+        if(timeline && delay > 0)
+            timeline->record(slice.idx, curTime, delay, RunReason::SWITCH);
+        curTime += delay;
+        overhead += delay;
+        int length = max(min(slice.length, min(preemptAt, nextWakeup) - curTime), 1);
+
+        if(chargeRun(procList, slice.idx, curTime, length, blocked))
+        {
+            ++numDone;
+            if(metrics)
+                metrics->complete(curTime + length - procList[slice.idx].startTime);
+        }
+        if(timeline)
+            timeline->record(slice.idx, curTime, length, runOutcome(procList[slice.idx]));
+        curTime += length;
+        lastTime = curTime - 1;
+        if(metrics && metrics->tick())
+            metrics->publish(lastTime, numDone, numProc, blocked.size(), policy);
+    }
+    if(metrics)
+        metrics->publish(lastTime, numDone, procList.size(), blocked.size(), policy, true);
+    return lastTime;
+}
+
+#endif
@@ -0,0 +1,776 @@
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include<climits>   // INT_MAX, LLONG_MAX
+#include<queue>     // priority_queue
+#include<tuple>
+#include "schedulers.h"
+#include "readyRing.h"
+
+//Each scheduler is a small class holding the state that used to live in function statics.
+//A simulation owns one instance per run, so the engine can be templated on the policy type
+//and the per tick call can be inlined. Schedulers that take a time quantum accept it as a
+//template parameter as well; Quantum == 0 means the quantum is given at runtime.
+//
+//Every scheduler has the same interface:
+//  admit(idx, curTime, procList)                  process idx arrived or woke up from IO by curTime
+//  nextSlice(curTime, nextArrival, procList)      decide what runs from curTime on
+//  next(curTime, procList)                        single time step decision (nextSlice for one step)
+//  readyLengths(lengths)                          fills in the length of each ready queue level and
+//                                                 returns the number of levels (for monitoring)
+//  reserve(count)                                 makes room in the ready queues for count processes,
+//                                                 so admitting and deciding then don't allocate
+//The engine calls admit for every arrival in start time order, and for every process whose IO
+//completed, before asking for a decision. A process that blocks on IO leaves the processor like
+//a completed one (isRunnable() turns false) and is dropped from the ready queues until it is
+//admitted again.
+//A scheduler never assumes a slice ran to completion; it charges the time that passed since
+//its last decision, so running a slice one step at a time gives the same schedule.
+
+//value used for "no time limit" in a slice
+const int NEVER = INT_MAX;
+
+//A scheduling decision: run process idx (-1 for idle) for up to length time steps, or until
+//preemptAt if that comes first, then ask the scheduler again.
+struct Slice
+{
+    int idx;        //process to run, -1 for idle
+    int length;     //time steps the process can run without the scheduler changing its mind
+    int preemptAt;  //time at which an arrival could change the decision (NEVER if it can't)
+};
+
+//time steps a scheduled process needs to finish its CPU burst; a process that already completed
+//but is scheduled anyway is given a single step, as the tick loop would
+inline int runLength(const Process& p)
+{
+    return p.isDone ? 1 : max(cpuBurstLeft(p), 1);
+}
+
+//slice used when nothing is ready: idle until the next arrival
+inline Slice idleSlice(int curTime, int nextArrival)
+{
+    return {-1, nextArrival == NEVER ? NEVER : nextArrival - curTime, nextArrival};
+}
+
+//makes room in an empty ready heap for count entries
+template<class Heap>
+void reserveHeap(Heap& heap, int count)
+{
+    typename Heap::container_type entries;
+    entries.reserve(count);
+    heap = Heap(typename Heap::value_compare(), move(entries));
+}
+
+//Round Robin: always schedules the head of the ready queue, rotating it every quantum
+template<int Quantum = 0>
+class RoundRobinScheduler
+{
+public:
+    explicit RoundRobinScheduler(int timeQuantum = Quantum)
+        : timeQuantum(timeQuantum), timeToNextSched(quantum()), lastDecision(0), running(false) {}
+
+    void reserve(int count)
+    {
+        ready.reserve(count);
+    }
+
+    void admit(int idx, int, const vector<Process>&)
+    {
+        ready.push_back(idx);
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        // charge the time the head has run since the last decision against the quantum
+        if(running)
+            timeToNextSched -= curTime - lastDecision;
+        lastDecision = curTime;
+        running = false;
+
+        // take a look the head of the ready queue, and update if needed
+        // (i.e., if we are supposed to schedule now or the process is done)
+        if(ready.size() > 0 && (timeToNextSched == 0 || !isRunnable(procList[ready[0]])))
+        {
+            // if the process isn't done or blocked, add it to the back of the ready queue
+            if(isRunnable(procList[ready[0]]))
+            {
+                ready.push_back(ready[0]);
+            }
+            ready.pop_front();
+            timeToNextSched = quantum();
+        }
+
+        if(ready.size() > 0)
+        {
+            // the head runs until its quantum expires or it completes
+            running = true;
+            return {ready[0], min(timeToNextSched, runLength(procList[ready[0]])), NEVER};
+        }
+        // try again when something arrives
+        timeToNextSched = 0;
+        return idleSlice(curTime, nextArrival);
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size();
+        return 1;
+    }
+
+private:
+    int quantum() const { return Quantum ? Quantum : timeQuantum; }
+
+    int timeQuantum;
+    int timeToNextSched;  //keeps track of when we should actually schedule a new process
+    int lastDecision;     //time of the last call to nextSlice
+    bool running;         //whether the last decision scheduled the head
+    ReadyRing ready;      //keeps track of the processes that are ready to be scheduled
+};
+
+//Shortest Process Next: non-preemptive. The ready queue is a heap ordered by estimated CPU burst
+//time (see setBursts()), ties in arrival order. The queue is only consulted at time 0 and when the running process
+//completes or blocks; a process arriving to an empty queue runs right away.
+class ShortestProcessNextScheduler
+{
+public:
+    ShortestProcessNextScheduler() : head(-1), seq(0) {}
+
+    void reserve(int count)
+    {
+        reserveHeap(ready, count);
+    }
+
+    void admit(int idx, int curTime, const vector<Process>& procList)
+    {
+        if(head < 0 && ready.empty() && curTime != 0)
+            head = idx;
+        else
+            ready.push(Entry(estimatedBurstTime(procList[idx]), seq++, idx));
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        //remove done or blocked and take the shortest
+        if((head >= 0 && !isRunnable(procList[head])) || (head < 0 && curTime == 0))
+        {
+            head = -1;
+            if(!ready.empty())
+            {
+                head = get<2>(ready.top());
+                ready.pop();
+            }
+        }
+        if(head < 0)
+            return idleSlice(curTime, nextArrival);
+        return {head, runLength(procList[head]), NEVER};
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size() + (head >= 0);
+        return 1;
+    }
+
+private:
+    typedef tuple<int, int, int> Entry;   //burst time, arrival sequence, process index
+
+    int head;   //process holding the processor
+    int seq;    //arrival counter used to break ties
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready; //processes waiting to be scheduled
+};
+
+//Shortest Remaining Time: preemptive. The ready queue is a heap ordered by the estimated time left
+//in the current CPU burst, ties in arrival order, and the running process is preempted as soon as
+//an arrival is shorter.
+class ShortestRemainingTimeScheduler
+{
+public:
+    ShortestRemainingTimeScheduler() : head(-1), headSeq(0), seq(0) {}
+
+    void reserve(int count)
+    {
+        reserveHeap(ready, count);
+    }
+
+    void admit(int idx, int, const vector<Process>& procList)
+    {
+        ready.push(Entry(estimatedBurstLeft(procList[idx]), seq++, idx));
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        if(head >= 0 && !isRunnable(procList[head]))
+            head = -1;
+        //preempt the running process if something waiting is shorter
+        if(!ready.empty() && (head < 0 || ready.top() < Entry(estimatedBurstLeft(procList[head]), headSeq, head)))
+        {
+            if(head >= 0)
+                ready.push(Entry(estimatedBurstLeft(procList[head]), headSeq, head));
+            head = get<2>(ready.top());
+            headSeq = get<1>(ready.top());
+            ready.pop();
+        }
+        if(head < 0)
+            return idleSlice(curTime, nextArrival);
+        return {head, runLength(procList[head]), nextArrival};
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size() + (head >= 0);
+        return 1;
+    }
+
+private:
+    typedef tuple<int, int, int> Entry;   //estimated time left in the burst, arrival sequence, process index
+
+    int head;       //process holding the processor
+    int headSeq;    //arrival sequence of the running process
+    int seq;        //arrival counter used to break ties
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready; //processes waiting to be scheduled
+};
+
+//Shared implementation of the response ratio schedulers; Ratio supplies the ordering key.
+//Non-preemptive: the next process is picked when the running process completes or blocks. The ratio
+//depends on the current time, so each pick is a pass over the waiting processes for the highest
+//ratio, ties to the earliest arrival and then the lowest index.
+template<double (*Ratio)(const int&, const Process&)>
+class ResponseRatioScheduler
+{
+public:
+    ResponseRatioScheduler() : head(-1) {}
+
+    void reserve(int count)
+    {
+        ready.reserve(count);
+    }
+
+    void admit(int idx, int, const vector<Process>&)
+    {
+        ready.push_back(idx);
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        //remove done or blocked and take the highest ratio, moving the last waiting process to its place
+        if(head >= 0 && !isRunnable(procList[head]))
+            head = -1;
+        if(head < 0 && ready.size() > 0)
+        {
+            size_t best = 0;
+            double bestRatio = Ratio(curTime, procList[ready[0]]);
+            for(size_t i = 1; i < ready.size(); ++i)
+            {
+                double ratio = Ratio(curTime, procList[ready[i]]);
+                if(ratio > bestRatio || (ratio == bestRatio && make_pair(procList[ready[i]].startTime, ready[i])
+                                                              < make_pair(procList[ready[best]].startTime, ready[best])))
+                {
+                    best = i;
+                    bestRatio = ratio;
+                }
+            }
+            head = ready[best];
+            ready[best] = ready.back();
+            ready.pop_back();
+        }
+        if(head < 0)
+            return idleSlice(curTime, nextArrival);
+        return {head, runLength(procList[head]), NEVER};
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size() + (head >= 0);
+        return 1;
+    }
+
+private:
+    int head;           //process holding the processor
+    vector<int> ready;  //processes waiting to be scheduled, in no particular order
+};
+
+//Highest Response Ratio Next: non-preemptive, orders by (W+S)/S
+typedef ResponseRatioScheduler<getResponseRatio> HighestResponseRatioNextScheduler;
+
+//Modified Highest Response Ratio Next: orders by response ratio weighted with priority
+typedef ResponseRatioScheduler<getModifiedResponseRatio> ModifiedHRRNScheduler;
+
+//First In First Out: non-preemptive, runs processes in order of arrival
+class FIFOScheduler
+{
+public:
+    void reserve(int count)
+    {
+        ready.reserve(count);
+    }
+
+    void admit(int idx, int, const vector<Process>&)
+    {
+        ready.push_back(idx);
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        if(ready.size() > 0 && !isRunnable(procList[ready[0]]))
+            ready.pop_front();
+        if(ready.size() == 0)
+            return idleSlice(curTime, nextArrival);
+        return {ready[0], runLength(procList[ready[0]]), NEVER};
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size();
+        return 1;
+    }
+
+private:
+    ReadyRing ready;  //queue of process that are ready to be scheduled
+};
+
+//adds process i to a priority queue level; a process with a higher priority (smaller number)
+//than the head goes in front
+inline void enqueueByPriority(ReadyRing& queue, int i, const vector<Process>& procList)
+{
+    if(queue.size() == 0)
+        queue.push_back(i);
+    else if(procList[i].priority < procList[queue[0]].priority)
+        queue.push_front(i);
+    else
+        queue.push_back(i);
+}
+
+//Multilevel Queue: priority 0 processes are scheduled Round Robin in the foreground queue and
+//preempt the background queue, which is scheduled FIFO
+template<int Quantum = 0>
+class MultilevelQueueScheduler
+{
+public:
+    explicit MultilevelQueueScheduler(int timeQuantum = Quantum)
+        : timeQuantum(timeQuantum), timeToNextSched(quantum()), lastDecision(0), runningForeground(false) {}
+
+    void reserve(int count)
+    {
+        foreground.reserve(count);
+        background.reserve(count);
+    }
+
+    void admit(int idx, int, const vector<Process>& procList)
+    {
+        dropBlocked(procList);
+        if(procList[idx].priority == 0)
+            enqueueByPriority(foreground, idx, procList);
+        else
+            enqueueByPriority(background, idx, procList);
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        // charge the time the foreground head has run since the last decision against the quantum
+        dropBlocked(procList);
+        if(runningForeground)
+            timeToNextSched -= curTime - lastDecision;
+        lastDecision = curTime;
+        runningForeground = false;
+
+        //FOREGROUND PROCESSES (HIGH PRIORITY ROUND ROBIN ALGORITHM)
+        if(foreground.size() > 0)
+        {
+            if((timeToNextSched == 0) || !isRunnable(procList[foreground[0]]))
+            {
+                if(isRunnable(procList[foreground[0]]))
+                {
+                    foreground.push_back(foreground[0]);
+                }
+                foreground.pop_front();
+                timeToNextSched = quantum();
+            }
+            if(foreground.size() > 0)
+            {
+                runningForeground = true;
+                return {foreground[0], min(timeToNextSched, runLength(procList[foreground[0]])), NEVER};
+            }
+            timeToNextSched = 0;
+            //the background head gets the processor (once, if it already completed)
+            if(background.size() > 0)
+                return backgroundSlice(nextArrival, procList);
+            return idleSlice(curTime, nextArrival);
+        }
+
+        //BACKGROUND PROCESSES (LOW PRIORITY FIRST IN FIRST OUT ALGORITHM)
+        if(background.size() > 0 && !isRunnable(procList[background[0]]))
+            background.pop_front();
+        if(background.size() > 0)
+            return backgroundSlice(nextArrival, procList);
+        return idleSlice(curTime, nextArrival);
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = foreground.size();
+        lengths[1] = background.size();
+        return 2;
+    }
+
+private:
+    int quantum() const { return Quantum ? Quantum : timeQuantum; }
+
+    //A process blocks on IO while running at the head of its queue. It leaves the queue at the
+    //next call, before an arrival can be put in front of it.
+    void dropBlocked(const vector<Process>& procList)
+    {
+        if(foreground.size() > 0 && procList[foreground[0]].isBlocked)
+        {
+            foreground.pop_front();
+            timeToNextSched = quantum();
+            runningForeground = false;
+        }
+        if(background.size() > 0 && procList[background[0]].isBlocked)
+            background.pop_front();
+    }
+
+    //the background head runs until it completes or a foreground process arrives
+    Slice backgroundSlice(int nextArrival, const vector<Process>& procList) const
+    {
+        const Process& p = procList[background[0]];
+        return {background[0], runLength(p), nextArrival};
+    }
+
+    int timeQuantum;
+    int timeToNextSched;    //keeps track of when we should actually schedule a new process
+    int lastDecision;       //time of the last call to nextSlice
+    bool runningForeground; //whether the last decision scheduled the foreground head
+    ReadyRing foreground;   //queue of foreground processes
+    ReadyRing background;   //queue of background processes
+};
+
+//Multilevel Feedback Queue: like the Multilevel Queue, but a foreground process that has run for
+//highQuantum is demoted and a background process that has waited lowQuantum is promoted.
+//Every background process ages by one each time step; the aging for the steps inside a slice
+//is applied when the scheduler is next called.
+template<int Quantum = 0>
+class MultilevelFeedbackQueueScheduler
+{
+public:
+    MultilevelFeedbackQueueScheduler(int timeQuantum, int highQuantum, int lowQuantum)
+        : timeQuantum(timeQuantum), highQuantum(highQuantum), lowQuantum(lowQuantum), timeToNextSched(quantum()),
+          lastDecision(0), lastAged(-1), runningForeground(false) {}
+
+    void reserve(int count)
+    {
+        foreground.reserve(count);
+        background.reserve(count);
+    }
+
+    void admit(int idx, int curTime, vector<Process>& procList)
+    {
+        age(curTime - 1, procList);
+        dropBlocked(procList);
+        if(procList[idx].priority == 0)
+            enqueueByPriority(foreground, idx, procList);
+        else
+            enqueueByPriority(background, idx, procList);
+    }
+
+    int next(int curTime, vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, vector<Process>& procList)
+    {
+        if(runningForeground)
+            timeToNextSched -= curTime - lastDecision;
+        lastDecision = curTime;
+        runningForeground = false;
+        age(curTime - 1, procList);
+        dropBlocked(procList);
+
+        if(foreground.size() > 0)
+        {
+            if(isRunnable(procList[foreground[0]]))
+            {
+                if((procList[foreground[0]].quantumTime % highQuantum == 0) && (procList[foreground[0]].quantumTime != 0))
+                {
+                    procList[foreground[0]].quantumTime = 0;
+                    background.push_back(foreground[0]); //move to lower queue
+                    foreground.pop_front(); //remove from high-priority queue
+                }
+            }
+        }
+        age(curTime, procList);
+        if(background.size() > 0)
+        {
+            if(isRunnable(procList[background[0]]))
+            {
+                if((procList[background[0]].waitTime == lowQuantum) && (procList[background[0]].quantumTime != 0))
+                {
+                    procList[background[0]].waitTime = 0;
+                    procList[background[0]].quantumTime = 0;
+                    foreground.push_back(background[0]); //move to higher queue
+                    background.pop_front(); //remove from low-priority queue
+                }
+            }
+        }
+
+        //FOREGROUND PROCESSES (HIGH PRIORITY ROUND ROBIN ALGORITHM)
+        if(foreground.size() > 0)
+        {
+            if((timeToNextSched == 0) || !isRunnable(procList[foreground[0]]))
+            {
+                if(isRunnable(procList[foreground[0]]))
+                {
+                    foreground.push_back(foreground[0]);
+                }
+                foreground.pop_front();
+                timeToNextSched = quantum();
+            }
+            if(foreground.size() > 0)
+            {
+                // the head runs until its quantum expires, it completes, it is demoted
+                // or the background head is promoted
+                const Process& p = procList[foreground[0]];
+                int length = min(timeToNextSched, runLength(p));
+                length = min(length, highQuantum - p.quantumTime % highQuantum);
+                length = min(length, stepsToPromotion(procList));
+                runningForeground = true;
+                return {foreground[0], length, nextArrival};
+            }
+            timeToNextSched = 0;
+            if(background.size() > 0)
+                return {background[0], 1, nextArrival};
+            return idleSlice(curTime, nextArrival);
+        }
+
+        //BACKGROUND PROCESSES (LOW PRIORITY FIRST IN FIRST OUT ALGORITHM)
+        if(background.size() > 0 && !isRunnable(procList[background[0]]))
+            background.pop_front();
+        if(background.size() > 0)
+        {
+            // the head runs until it completes or it is promoted
+            const Process& p = procList[background[0]];
+            int length = runLength(p);
+            if(p.waitTime < lowQuantum)
+                length = min(length, lowQuantum - p.waitTime);
+            return {background[0], length, nextArrival};
+        }
+        return idleSlice(curTime, nextArrival);
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = foreground.size();
+        lengths[1] = background.size();
+        return 2;
+    }
+
+private:
+    int quantum() const { return Quantum ? Quantum : timeQuantum; }
+
+    //A process blocks on IO while running at the head of its queue. It leaves the queue at the
+    //next call, before an arrival can be put in front of it.
+    void dropBlocked(const vector<Process>& procList)
+    {
+        if(foreground.size() > 0 && procList[foreground[0]].isBlocked)
+        {
+            foreground.pop_front();
+            timeToNextSched = quantum();
+            runningForeground = false;
+        }
+        if(background.size() > 0 && procList[background[0]].isBlocked)
+            background.pop_front();
+    }
+
+    //every background process waits one more time step for each step up to and including time
+    void age(int time, vector<Process>& procList)
+    {
+        if(time <= lastAged)
+            return;
+        int steps = time - lastAged;
+        for(unsigned int i = 0; i < background.size(); i++)
+            procList[background[i]].waitTime += steps;
+        lastAged = time;
+    }
+
+    //time steps until the waiting background head would be promoted
+    int stepsToPromotion(const vector<Process>& procList) const
+    {
+        if(background.size() == 0)
+            return NEVER;
+        const Process& p = procList[background[0]];
+        if(!isRunnable(p) || p.quantumTime == 0 || p.waitTime >= lowQuantum)
+            return NEVER;
+        return lowQuantum - p.waitTime;
+    }
+
+    int timeQuantum;
+    int highQuantum;        //time a foreground process runs before it is demoted
+    int lowQuantum;         //time a background process waits before it is promoted
+    int timeToNextSched;    //keeps track of when we should actually schedule a new process
+    int lastDecision;       //time of the last call to nextSlice
+    int lastAged;           //last time step the background queue was aged for
+    bool runningForeground; //whether the last decision scheduled the foreground head
+    ReadyRing foreground;   //queue of foreground processes
+    ReadyRing background;   //queue of background processes
+};
+
+//Earliest Deadline First: the ready queue is a heap ordered by absolute deadline, ties in arrival
+//order; processes without a deadline come after every process with one. Preemptive, the running
+//process is preempted as soon as an arrival has an earlier deadline; non-preemptive, the queue is
+//only consulted when the running process completes or blocks.
+template<bool Preemptive>
+class EarliestDeadlineFirstScheduler
+{
+public:
+    EarliestDeadlineFirstScheduler() : head(-1), headSeq(0), seq(0) {}
+
+    void reserve(int count)
+    {
+        reserveHeap(ready, count);
+    }
+
+    void admit(int idx, int, const vector<Process>& procList)
+    {
+        ready.push(Entry(absoluteDeadline(procList[idx]), seq++, idx));
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        if(head >= 0 && !isRunnable(procList[head]))
+            head = -1;
+        if(!ready.empty() && (head < 0 || (Preemptive && ready.top() < Entry(absoluteDeadline(procList[head]), headSeq, head))))
+        {
+            if(head >= 0)
+                ready.push(Entry(absoluteDeadline(procList[head]), headSeq, head));
+            head = get<2>(ready.top());
+            headSeq = get<1>(ready.top());
+            ready.pop();
+        }
+        if(head < 0)
+            return idleSlice(curTime, nextArrival);
+        return {head, runLength(procList[head]), Preemptive ? nextArrival : NEVER};
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size() + (head >= 0);
+        return 1;
+    }
+
+private:
+    typedef tuple<int, int, int> Entry;   //absolute deadline, arrival sequence, process index
+
+    int head;       //process holding the processor
+    int headSeq;    //arrival sequence of the running process
+    int seq;        //arrival counter used to break ties
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready; //processes waiting to be scheduled
+};
+
+//Least Laxity First: preemptive, runs the process with the least slack, its deadline less the
+//current time and the CPU time it is estimated to still need. Every waiting process loses slack at the same
+//rate, so the heap is ordered by deadline less CPU time left, which only changes for the running
+//process: its key grows by one each step it runs, and it is preempted once a waiting key is
+//smaller. Equal keys leave the running process running, which halves the switching between
+//processes of equal laxity. Processes without a deadline come last, in arrival order.
+class LeastLaxityFirstScheduler
+{
+public:
+    LeastLaxityFirstScheduler() : head(-1), headSeq(0), seq(0) {}
+
+    void reserve(int count)
+    {
+        reserveHeap(ready, count);
+    }
+
+    void admit(int idx, int, const vector<Process>& procList)
+    {
+        ready.push(Entry(key(procList[idx]), seq++, idx));
+    }
+
+    int next(int curTime, const vector<Process>& procList)
+    {
+        return nextSlice(curTime, curTime + 1, procList).idx;
+    }
+
+    Slice nextSlice(int curTime, int nextArrival, const vector<Process>& procList)
+    {
+        if(head >= 0 && !isRunnable(procList[head]))
+            head = -1;
+        if(!ready.empty() && (head < 0 || get<0>(ready.top()) < key(procList[head])))
+        {
+            if(head >= 0)
+                ready.push(Entry(key(procList[head]), headSeq, head));
+            head = get<2>(ready.top());
+            headSeq = get<1>(ready.top());
+            ready.pop();
+        }
+        if(head < 0)
+            return idleSlice(curTime, nextArrival);
+        //runs until its key passes the smallest waiting one
+        long long length = runLength(procList[head]);
+        long long own = key(procList[head]);
+        if(!ready.empty() && own != NO_DEADLINE && get<0>(ready.top()) != NO_DEADLINE)
+            length = min(length, get<0>(ready.top()) - own + 1);
+        return {head, static_cast<int>(length), nextArrival};
+    }
+
+    int readyLengths(long long lengths[]) const
+    {
+        lengths[0] = ready.size() + (head >= 0);
+        return 1;
+    }
+
+private:
+    typedef tuple<long long, int, int> Entry;   //key, arrival sequence, process index
+
+    static constexpr long long NO_DEADLINE = LLONG_MAX;
+
+    //deadline less the CPU time the process is estimated to still need, the laxity plus the current time
+    static long long key(const Process& p)
+    {
+        int relative = relativeDeadline(p);
+        return relative > 0 ? static_cast<long long>(p.startTime) + relative - (estimate(p, p.totalTimeNeeded) - p.timeScheduled) : NO_DEADLINE;
+    }
+
+    int head;       //process holding the processor
+    int headSeq;    //arrival sequence of the running process
+    int seq;        //arrival counter used to break ties
+    priority_queue<Entry, vector<Entry>, greater<Entry>> ready; //processes waiting to be scheduled
+};
+
+#endif
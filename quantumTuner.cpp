@@ -0,0 +1,311 @@
+#include<atomic>   // next candidate to take
+#include<thread>   // evaluation threads
+#include<chrono>   // run times
+#include<random>   // candidate sample
+#include<iomanip>  // setw
+#include<array>
+#include<map>      // evaluated quanta
+#include<numeric>  // iota
+#include "quantumTuner.h"
+#include "stats.h"
+
+using namespace std::chrono;
+
+//successive halving starts from at most this many candidates
+static const size_t MAX_CANDIDATES = 64;
+
+//the smallest share of the workload a candidate is judged on, in processes
+static const size_t MIN_PREFIX = 64;
+
+//the objective's metrics, by name
+enum TuningMetric { TURNAROUND, NORMALIZED, WAIT, P90, P99, MAX, P99WAIT, SWITCHES, OVERHEAD, MISSES, NUM_TUNING_METRICS };
+static const char* const TUNING_METRICS[NUM_TUNING_METRICS] = {"turnaround", "normalized", "wait", "p90", "p99", "max",
+    "p99wait", "switches", "overhead", "misses"};
+
+typedef array<int, 3> Quanta;   //quantum, high quantum, low quantum
+
+static string trim(const string& s)
+{
+    size_t begin = s.find_first_not_of(" \t");
+    if(begin == string::npos)
+        return "";
+    return s.substr(begin, s.find_last_not_of(" \t") - begin + 1);
+}
+
+bool TuningObjective::parse(const string& text, string& error)
+{
+    this->text = text;
+    terms.clear();
+    size_t begin = 0;
+    while(true)
+    {
+        size_t plus = text.find('+', begin);
+        string term = trim(text.substr(begin, plus == string::npos ? string::npos : plus - begin));
+        double weight = 1;
+        size_t star = term.find('*');
+        if(star != string::npos)
+        {
+            char* end;
+            string w = trim(term.substr(0, star));
+            weight = strtod(w.c_str(), &end);
+            if(w.empty() || *end != '\0')
+            {
+                error = "invalid weight \"" + w + "\" in objective \"" + text + "\"";
+                return false;
+            }
+            term = trim(term.substr(star + 1));
+        }
+        int m = find(TUNING_METRICS, TUNING_METRICS + NUM_TUNING_METRICS, term) - TUNING_METRICS;
+        if(m == NUM_TUNING_METRICS)
+        {
+            error = "unknown metric \"" + term + "\" in objective \"" + text + "\"";
+            return false;
+        }
+        terms.push_back(make_pair(weight, m));
+        if(plus == string::npos)
+            return true;
+        begin = plus + 1;
+    }
+}
+
+//99th percentile CPU wait time of a finished run (nearest rank)
+static int cpuWaitPercentile99(const vector<Process>& procList)
+{
+    if(procList.empty())
+        return 0;
+    ProcessColumns columns;
+    columns.load(procList);
+    vector<int> wait(columns.size());
+    for(size_t i = 0; i < columns.size(); ++i)
+        wait[i] = columns.finish[i] + 1 - columns.start[i] - columns.total[i] - columns.io[i];
+    auto nth = wait.begin() + (max((static_cast<long long>(wait.size()) * 99 + 99) / 100, 1LL) - 1);
+    nth_element(wait.begin(), nth, wait.end());
+    return *nth;
+}
+
+static double objectiveValue(const TuningObjective& objective, const TunedQuanta& t)
+{
+    const RunResult& r = t.result;
+    double value = 0;
+    for(auto& term: objective.terms)
+    {
+        double metric = 0;
+        switch(term.second)
+        {
+            case TURNAROUND: metric = r.avgTurnaround; break;
+            case NORMALIZED: metric = r.avgNormalizedTurnaround; break;
+            case WAIT: metric = r.avgCpuWait; break;
+            case P90: metric = r.turnaround90; break;
+            case P99: metric = r.turnaround99; break;
+            case MAX: metric = r.maxTurnaround; break;
+            case P99WAIT: metric = t.cpuWait99; break;
+            case SWITCHES: metric = r.switches; break;
+            case OVERHEAD: metric = r.switchOverhead; break;
+            case MISSES: metric = r.deadlineMissRatio; break;
+        }
+        value += term.first * metric;
+    }
+    return value;
+}
+
+//Simulates and scores each of candidates on its own copy of workload, on up to numThreads
+//threads. Each result has its own slot, so they don't depend on the thread count.
+static vector<TunedQuanta> evaluateAll(const vector<Quanta>& candidates, const vector<Process>& workload, int schedChoice,
+                                       const TuningObjective& objective, double switchCost, double switchCostPerWorkingSet, int numThreads)
+{
+    vector<TunedQuanta> results(candidates.size());
+    atomic<size_t> nextCandidate(0);
+    auto work = [&]()
+    {
+        for(size_t i; (i = nextCandidate++) < candidates.size();)
+        {
+            const Quanta& q = candidates[i];
+            vector<Process> procList = workload;
+            SwitchModel switches(switchCost, switchCostPerWorkingSet);
+            TunedQuanta& t = results[i];
+            t.quantum = q[0];
+            t.highQuantum = q[1];
+            t.lowQuantum = q[2];
+            t.result = RunResult();
+            auto start = high_resolution_clock::now();
+            withScheduler(schedChoice, q[0], q[1], q[2], [&](auto& sched) { t.result.lastTime = simulateSlices(sched, procList, switches); });
+            t.result.runtimeUs = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+            summarizeRun(procList, switches, t.result);
+            t.cpuWait99 = cpuWaitPercentile99(procList);
+            t.objective = objectiveValue(objective, t);
+        }
+    };
+    vector<thread> workers;
+    for(int t = 1; t < numThreads && t < static_cast<int>(candidates.size()); ++t)
+        workers.emplace_back(work);
+    work();
+    for(auto& worker: workers)
+        worker.join();
+    return results;
+}
+
+//quanta about two to an octave: 1, 2, 3, 4, 6, 8, 12, ... up to and including max
+static vector<int> quantumLadder(int max)
+{
+    vector<int> ladder;
+    for(long long v = 1; v < max; v = v < 2 ? 2 : (v & (v - 1)) ? v / 3 * 4 : v / 2 * 3)
+        ladder.push_back(v);
+    ladder.push_back(max);
+    return ladder;
+}
+
+//the processes of workload with the count earliest arrivals, in workload order
+static vector<Process> earliestArrivals(const vector<Process>& workload, size_t count)
+{
+    if(count >= workload.size())
+        return workload;
+    vector<size_t> order(workload.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return workload[a].startTime < workload[b].startTime; });
+    order.resize(count);
+    sort(order.begin(), order.end());
+    vector<Process> prefix;
+    for(size_t i: order)
+        prefix.push_back(workload[i]);
+    return prefix;
+}
+
+bool tuneQuanta(const vector<Process>& workload, int schedChoice, const TuningObjective& objective, const int maxQuanta[3],
+                double switchCost, double switchCostPerWorkingSet, int numThreads, TunedQuanta& best, string& error)
+{
+    if(schedChoice != 1 && schedChoice != 7 && schedChoice != 8)
+    {
+        error = "scheduler " + to_string(schedChoice) + " has no quanta to tune";
+        return false;
+    }
+    if(numThreads <= 0)
+        numThreads = max(1u, thread::hardware_concurrency());
+    int dims = schedChoice == 8 ? 3 : 1;
+    auto evaluate = [&](const vector<Quanta>& candidates, const vector<Process>& w)
+    {
+        return evaluateAll(candidates, w, schedChoice, objective, switchCost, switchCostPerWorkingSet, numThreads);
+    };
+
+    //the grid, sampled down to MAX_CANDIDATES
+    vector<Quanta> candidates(1, Quanta{{0, 0, 0}});
+    for(int d = 0; d < dims; ++d)
+    {
+        vector<Quanta> grown;
+        for(const Quanta& q: candidates)
+            for(int v: quantumLadder(max(maxQuanta[d], 1)))
+            {
+                grown.push_back(q);
+                grown.back()[d] = v;
+            }
+        candidates.swap(grown);
+    }
+    if(candidates.size() > MAX_CANDIDATES)
+    {
+        shuffle(candidates.begin(), candidates.end(), mt19937(1));
+        candidates.resize(MAX_CANDIDATES);
+    }
+
+    //successive halving: each round judges the candidates on twice the arrivals of the last,
+    //ending on half the workload, and keeps the better half
+    while(candidates.size() > 1)
+    {
+        int roundsLeft = 0;
+        while((static_cast<size_t>(1) << roundsLeft) < candidates.size())
+            ++roundsLeft;
+        size_t share = max(workload.size() >> roundsLeft, min(workload.size(), MIN_PREFIX));
+        vector<TunedQuanta> results = evaluate(candidates, earliestArrivals(workload, share));
+        vector<size_t> order(candidates.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].objective < results[b].objective; });
+        vector<Quanta> kept;
+        for(size_t i = 0; i < (candidates.size() + 1) / 2; ++i)
+            kept.push_back(candidates[order[i]]);
+        candidates.swap(kept);
+    }
+
+    //coordinate descent on the whole workload from the survivor
+    map<Quanta, TunedQuanta> seen;
+    Quanta current = candidates[0];
+    seen[current] = evaluate(candidates, workload)[0];
+    Quanta step;
+    for(int d = 0; d < 3; ++d)
+        step[d] = d < dims ? max(current[d] / 2, 1) : 0;
+    while(true)
+    {
+        vector<Quanta> neighbours;
+        for(int d = 0; d < dims; ++d)
+            for(int sign: {-1, 1})
+            {
+                Quanta q = current;
+                q[d] = min(max(q[d] + sign * step[d], 1), max(maxQuanta[d], 1));
+                if(!seen.count(q) && find(neighbours.begin(), neighbours.end(), q) == neighbours.end())
+                    neighbours.push_back(q);
+            }
+        vector<TunedQuanta> results = evaluate(neighbours, workload);
+        Quanta next = current;
+        for(size_t i = 0; i < neighbours.size(); ++i)
+        {
+            seen[neighbours[i]] = results[i];
+            if(results[i].objective < seen[next].objective)
+                next = neighbours[i];
+        }
+        if(next != current)
+        {
+            current = next;
+            continue;
+        }
+        if(*max_element(step.begin(), step.end()) <= 1)
+            break;
+        for(int d = 0; d < dims; ++d)
+            step[d] = max(step[d] / 2, 1);
+    }
+    best = seen[current];
+    return true;
+}
+
+bool runTuner(const vector<Process>& workload, int schedChoice, const string& objectiveText, double switchCost,
+              double switchCostPerWorkingSet, string& error)
+{
+    TuningObjective objective;
+    if(!objective.parse(objectiveText, error))
+        return false;
+    //quanta past the longest CPU burst all schedule alike
+    int longest = 1;
+    for(const Process& p: workload)
+    {
+        if(p.extras && burstPool()[p.extras + 1] != END_OF_BURSTS)
+            for(uint32_t i = p.extras + 1; burstPool()[i] != END_OF_BURSTS; i += 2)
+            {
+                longest = max(longest, burstPool()[i]);
+                if(burstPool()[i + 1] == END_OF_BURSTS)
+                    break;
+            }
+        else
+            longest = max(longest, p.totalTimeNeeded);
+    }
+    longest = min(longest, 1 << 20);
+    int maxQuanta[3] = {longest, longest, 4 * longest};
+
+    TunedQuanta best;
+    int threads = max(1u, thread::hardware_concurrency());
+    auto start = high_resolution_clock::now();
+    if(!tuneQuanta(workload, schedChoice, objective, maxQuanta, switchCost, switchCostPerWorkingSet, threads, best, error))
+        return false;
+    long long elapsedMs = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+
+    cout << "\n\nTuned for \"" << objective.text << "\" in " << elapsedMs << " ms on " << threads << " threads\n"
+         << "Best quanta: quantum=" << best.quantum;
+    if(schedChoice == 8)
+        cout << "," << best.highQuantum << "," << best.lowQuantum;
+    const RunResult& r = best.result;
+    cout << setprecision(2) << fixed << " (objective " << best.objective << ")\n"
+         << "  Finish time:                " << r.lastTime + 1 << "\n"
+         << "  Mean turnaround:            " << r.avgTurnaround << "\n"
+         << "  99th turnaround:            " << r.turnaround99 << "\n"
+         << "  Mean normalized turnaround: " << r.avgNormalizedTurnaround << "\n"
+         << "  Mean CPU wait time:         " << r.avgCpuWait << "\n"
+         << "  99th CPU wait time:         " << best.cpuWait99 << "\n"
+         << "  Context switches:           " << r.switches << "\n"
+         << "  Deadline misses:            " << 100 * r.deadlineMissRatio << "%\n";
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef QUANTUMTUNER_H
+#define QUANTUMTUNER_H
+
+#include "experiment.h"
+
+//What the tuner minimizes: a weighted sum of run metrics, written "[<weight>*]<metric>" terms
+//joined by "+", e.g. "normalized" or "0.8*normalized+0.02*p99wait". The metrics are
+//  turnaround, normalized, wait    mean turnaround, normalized turnaround and CPU wait time
+//  p90, p99, max                   turnaround time tails
+//  p99wait                         99th percentile CPU wait time
+//  switches, overhead, misses      context switches, switch overhead, deadline miss ratio
+struct TuningObjective
+{
+    vector<pair<double, int>> terms;    //weight and metric
+    string text;
+
+    //parses text; returns false and sets error if it isn't an objective
+    bool parse(const string& text, string& error);
+};
+
+//The quanta of a scheduler, with what a run with them measured
+struct TunedQuanta
+{
+    int quantum;
+    int highQuantum;
+    int lowQuantum;
+    double objective;
+    RunResult result;
+    int cpuWait99;
+};
+
+//Tunes the quanta of scheduler schedChoice (1, 7 or 8, see the main menu) for workload. The search
+//runs successive halving over a grid of quanta spaced about two to an octave up to maxQuanta
+//(quantum, high and low), starting on the first arrivals of the workload and doubling the share
+//each round while keeping the better half, then refines the winner on the whole workload by
+//coordinate descent: the quanta a step either side on every axis are tried, the best taken, and
+//the step halved when none is better. Each round's candidates are simulated in parallel on
+//numThreads threads (0 for one per core), on their own copies of the workload. Returns false and
+//sets error for a scheduler without quanta.
+bool tuneQuanta(const vector<Process>& workload, int schedChoice, const TuningObjective& objective, const int maxQuanta[3],
+                double switchCost, double switchCostPerWorkingSet, int numThreads, TunedQuanta& best, string& error);
+
+//Runs tuneQuanta with default bounds (the longest CPU burst for the quantum and the high quantum,
+//four times that for the low one) and prints what it found
+bool runTuner(const vector<Process>& workload, int schedChoice, const string& objectiveText, double switchCost,
+              double switchCostPerWorkingSet, string& error);
+
+#endif
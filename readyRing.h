@@ -0,0 +1,71 @@
+#ifndef READYRING_H
+#define READYRING_H
+
+#include<vector>
+#include<cstddef> // size_t
+
+using namespace std;
+
+//Ready queue of process indices for the queue based policies: a ring buffer whose size is a power
+//of two, with the part of deque's interface they use. Unlike a deque it only allocates when it
+//outgrows its buffer, so a queue reserved for every process never allocates.
+class ReadyRing
+{
+public:
+    ReadyRing() : first(0), count(0) {}
+
+    size_t size() const { return count; }
+
+    //makes room for entries indices, so queueing up to that many doesn't allocate
+    void reserve(size_t entries)
+    {
+        if(entries > slots.size())
+            grow(entries);
+    }
+
+    int operator[](size_t i) const { return slots[(first + i) & mask()]; }
+
+    void push_back(int idx)
+    {
+        if(count == slots.size())
+            grow(count + 1);
+        slots[(first + count++) & mask()] = idx;
+    }
+
+    void push_front(int idx)
+    {
+        if(count == slots.size())
+            grow(count + 1);
+        first = (first - 1) & mask();
+        slots[first] = idx;
+        ++count;
+    }
+
+    void pop_front()
+    {
+        first = (first + 1) & mask();
+        --count;
+    }
+
+private:
+    size_t mask() const { return slots.size() - 1; }
+
+    //moves the entries, in order, to the start of a buffer of at least entries slots
+    void grow(size_t entries)
+    {
+        size_t capacity = 16;
+        while(capacity < entries)
+            capacity *= 2;
+        vector<int> bigger(capacity);
+        for(size_t i = 0; i < count; ++i)
+            bigger[i] = (*this)[i];
+        slots.swap(bigger);
+        first = 0;
+    }
+
+    vector<int> slots;
+    size_t first;   //slot of the head
+    size_t count;   //entries queued
+};
+
+#endif
@@ -9,7 +9,19 @@
 #include<iomanip>  // setw 
 #include<stdio.h>
 #include<fstream>
-#include "schedulers.h"    
+#include<memory>   // unique_ptr
+#include<cmath>    // sqrt
+#include "simulator.h"
+#include "traceImport.h"
+#include "experiment.h"
+#include "distributed.h"
+#include "stats.h"
+#include "analytic.h"
+#include "incremental.h"
+#include "online.h"
+#include "emulation.h"
+#include "quantumTuner.h"
+#include "fairShare.h"
 
 using namespace std::chrono;
 using std::cout;
@@ -19,19 +31,114 @@ using std::cin;
 //constant for number of processes to run
 const int n = 10;
 
+//Picks the scheduler with a switch on every time step, calling the out of line scheduler
+//functions, which scan the whole process list for arrivals each step. Benchmark mode times it for
+//the cost of that dispatch; the functions wrap the same policy classes, so it isn't the original
+//schedulers' code and isn't a before and after comparison.
+struct DynamicDispatch
+{
+    int schedChoice, timeQuantum, highQuantum, lowQuantum;
+
+    //the scheduler functions look for their own arrivals
+    void admit(int, int, const vector<Process>&) {}
+
+    //their queues are function statics, out of sight
+    int readyLengths(long long[]) const { return 0; }
+
+    int next(int curTime, vector<Process>& procList)
+    {
+        switch(schedChoice)
+        {
+            //Round Robin
+            case 1:
+                return RoundRobin(curTime, procList, timeQuantum);
+            //Shortest Process Next
+            case 2:
+                return ShortestProcessNext(curTime,procList);
+            //Shortest Remaining Time
+            case 3:
+                return ShortestRemainingTime(curTime,procList);
+            //Highest Response Ratio Next
+            case 4:
+                return HighestResponseRatioNext(curTime,procList);
+            //Modified Highest Response Ratio Next
+            case 5:
+                return Modified_HRRN(curTime,procList);
+            //First in First Out
+            case 6:
+                return FIFO(curTime,procList);
+            //Multilevel Queue
+            case 7:
+                return MultilevelQueue(curTime,procList,timeQuantum);
+            //Multilevel Feedback Queue
+            case 8:
+                return MultilevelFeedbackQueue(curTime,procList,timeQuantum,highQuantum,lowQuantum);
+            //Earliest Deadline First
+            case 9:
+                return EarliestDeadlineFirst(curTime,procList);
+            //Non-preemptive Earliest Deadline First
+            case 10:
+                return NonPreemptiveEarliestDeadlineFirst(curTime,procList);
+            //Least Laxity First
+            case 11:
+                return LeastLaxityFirst(curTime,procList);
+        }
+        return -1;
+    }
+};
+
 int main(int argc, char* argv[])
 {
     vector<int>timeList;
     string fname;
     chrono::duration<int, std::milli> sleepTime = chrono::milliseconds(500);
     vector<Process> procList;
-    int curTime = 0, input, schedChoice, numProc, procIdx, timeQuantum, highQuantum, lowQuantum;
+    int input, schedChoice = 0, numProc, timeQuantum = 0, highQuantum = 0, lowQuantum = 0;
     bool inputGiven = false;
-    bool done;
-    string tempStr;
+    bool quantaGiven = false;
+    bool compare = false;
+    bool benchmark = false;
+    bool slices = false;
+    bool online = false;
+    bool dropWhenFull = false;
+    int emulateTickUs = 0, emulateCores = 1;
+    double switchCost = 0, switchCostPerWorkingSet = 0;
+    string metricsAddress, timelinePath, tuneObjective;
+    vector<string> whatIfPaths;
+    vector<string> feeds(1);   //the workload file itself
+    unique_ptr<FairShareConfig> fairShare;
     srand(time(NULL));
 
+    //"experiment=<spec file>" runs a whole batch of simulations without prompts (see experiment.h);
+    //with "serve=<address>" after it the runs are handed out to workers instead (see distributed.h)
+    if(argc >= 2 && string(argv[1]).compare(0, 11, "experiment=") == 0)
+    {
+        ExperimentSpec spec;
+        string error;
+        bool serve = argc >= 3 && string(argv[2]).compare(0, 6, "serve=") == 0;
+        if(!readExperimentSpec(argv[1] + 11, spec, error)
+           || !(serve ? coordinateExperiment(spec, argv[2] + 6, error) : runExperiment(spec, error)))
+        {
+            cerr << error << endl;
+            return -1;
+        }
+        return 0;
+    }
+
+    //"worker=<address>" simulates runs handed out by an experiment served at address
+    if(argc >= 2 && string(argv[1]).compare(0, 7, "worker=") == 0)
+    {
+        string error;
+        if(!runWorker(argv[1] + 7, error))
+        {
+            cerr << error << endl;
+            return -1;
+        }
+        return 0;
+    }
+
     //Default to process list simulation. See procList.txt for process example setup.
+    //The file can also be a perf sched / ftrace dump or a /proc/<pid>/schedstat dump (see traceImport.h)
     if(argc == 1)
     {
         fname = "procList.txt";
@@ -44,8 +151,105 @@ int main(int argc, char* argv[])
     else
     {
         fname = argv[1];
-        input = stoi(argv[2]);
+        //"compare" instead of a choice runs every scheduler on the workload (see comparePolicies)
+        compare = string(argv[2]) == "compare";
+        input = compare ? 8 : stoi(argv[2]);
         inputGiven = true;
+        // after the choice, "bench" times the simulation instead of printing the run table (checking every
+        // policy with its quanta given for a slice run that matches its tick run under "fairshare"),
+        // "slices" runs the slice granular simulation without the run table and
+        // "switch=<cost>[,<cost per working set unit>]" charges for context switches (see switchModel.h),
+        // "quantum=<quantum>[,<high quantum>,<low quantum>]" gives the quanta instead of asking for them,
+        // "metrics=<socket path>" or "metrics=:<port>" serves live metrics while the simulation runs (see metrics.h),
+        // "timeline=<file>" writes the schedule as Chrome trace event JSON (see timeline.h),
+        // "whatif=<file>", repeatable, re-simulates a changed workload from a checkpoint (see incremental.h),
+        // "online" streams the workload to the simulation from a producer thread (see online.h),
+        // "feed=generate:<count>[,<seed>]" or "feed=listen:<address>", repeatable, adds a producer,
+        // "drop" has producers drop arrivals instead of waiting when the simulation falls behind,
+        // "emulate=<us per time step>[,<cores>]" runs the schedule as busy work on pinned threads (see emulation.h),
+        // "fairshare[=<group>:<weight>,...]" shares the processor between the workload's groups, each
+        // scheduled by the chosen scheduler, and "groupslice=<steps>" sets how long a group runs at a time (see fairShare.h) and
+        // "tune[=<objective>]" searches for the quanta minimizing the objective instead (see quantumTuner.h)
+        for(int i = 3; i < argc; ++i)
+        {
+            string arg = argv[i];
+            if(arg == "bench")
+                benchmark = true;
+            else if(arg == "slices")
+                slices = true;
+            else if(arg.compare(0, 7, "switch=") == 0)
+            {
+                switchCost = atof(arg.c_str() + 7);
+                size_t comma = arg.find(',');
+                if(comma != string::npos)
+                    switchCostPerWorkingSet = atof(arg.c_str() + comma + 1);
+            }
+            else if(arg.compare(0, 8, "metrics=") == 0)
+                metricsAddress = arg.substr(8);
+            else if(arg.compare(0, 9, "timeline=") == 0)
+                timelinePath = arg.substr(9);
+            else if(arg.compare(0, 7, "whatif=") == 0)
+                whatIfPaths.push_back(arg.substr(7));
+            else if(arg == "online")
+                online = true;
+            else if(arg.compare(0, 5, "feed=") == 0)
+            {
+                online = true;
+                feeds.push_back(arg.substr(5));
+            }
+            else if(arg == "drop")
+                dropWhenFull = true;
+            else if(arg == "tune")
+                tuneObjective = "normalized";
+            else if(arg.compare(0, 5, "tune=") == 0)
+                tuneObjective = arg.substr(5);
+            else if(arg == "fairshare" || arg.compare(0, 10, "fairshare=") == 0 || arg.compare(0, 11, "groupslice=") == 0)
+            {
+                if(!fairShare)
+                    fairShare.reset(new FairShareConfig);
+                string error;
+                if(arg.compare(0, 11, "groupslice=") == 0)
+                {
+                    fairShare->groupSlice = atoi(arg.c_str() + 11);
+                    if(fairShare->groupSlice < 1)
+                    {
+                        cerr << "Invalid group slice \"" << arg << "\"" << endl;
+                        return -1;
+                    }
+                }
+                else if(arg != "fairshare" && !fairShare->parse(arg.substr(10), error))
+                {
+                    cerr << error << endl;
+                    return -1;
+                }
+            }
+            else if(arg.compare(0, 8, "emulate=") == 0)
+            {
+                if(sscanf(arg.c_str() + 8, "%d,%d", &emulateTickUs, &emulateCores) < 1 || emulateTickUs < 1)
+                {
+                    cerr << "Invalid emulation \"" << arg << "\"" << endl;
+                    return -1;
+                }
+            }
+            else if(arg.compare(0, 8, "quantum=") == 0)
+            {
+                quantaGiven = true;
+                int given = sscanf(arg.c_str() + 8, "%d,%d,%d", &timeQuantum, &highQuantum, &lowQuantum);
+                bool quantum = input == 1 || input == 7 || input == 8;
+                if(given < 1 || (quantum && timeQuantum < 1) || (input == 8 && (given < 3 || highQuantum < 1)))
+                {
+                    cerr << "Invalid quanta \"" << arg << "\"" << endl;
+                    return -1;
+                }
+            }
+        }
+        //the per step dispatch loop finds its own arrivals by the scheduler's clock, which
+        //stands still during a switch, so it can't be timed with switch costs
+        if(benchmark && !compare && (switchCost != 0 || switchCostPerWorkingSet != 0))
+        {
+            cerr << "Switch costs aren't modeled in bench mode, run with \"slices\" instead" << endl;
+            return -1;
+        }
     }
     
     //read in the process list and store the total number of processes
@@ -61,199 +265,289 @@ int main(int argc, char* argv[])
         << "5) Modified Highest Response Ratio next\n"
         << "6) First In First Out\n"
         << "7) Multilvel Queue\n"
-        << "8) Multilevel Feedback Queue\n";
+        << "8) Multilevel Feedback Queue\n"
+        << "9) Earliest Deadline First\n"
+        << "10) Non-preemptive Earliest Deadline First\n"
+        << "11) Least Laxity First\n";
     cout << "\n--> ";
     if(inputGiven == false)
         cin >> input;
-    if(input > 0 && input <= 8)
+    if(input > 0 && input <= 11)
     {
         schedChoice = input;
     }
     else
     {
         cout << "INVALID ENTRY\n\n";
+        return -1;
     }
 
     
     //if the scheduler selected needs a time quantum, ask for it
-    if((schedChoice == 1) || (schedChoice >= 7))
+    if(((schedChoice == 1) || (schedChoice == 7) || (schedChoice == 8)) && !quantaGiven && tuneObjective.empty())
     {
         cout << "Enter the time quantum you would like to use: ";
         cin >> timeQuantum;
     }
-    if(schedChoice == 8)
+    if(schedChoice == 8 && !quantaGiven && tuneObjective.empty())
     {
         cout << "Enter the high-priority switch time quantum: ";
         cin >> highQuantum;
         cout << "Enter the low-priority switch time quantum: ";
         cin >> lowQuantum;
     }
+    //a quantum below 1 never expires, as in readExperimentSpec()
+    if(((schedChoice == 1) || (schedChoice == 7) || (schedChoice == 8)) && tuneObjective.empty()
+       && (timeQuantum < 1 || (schedChoice == 8 && highQuantum < 1)))
+    {
+        cout << "INVALID QUANTA\n\n";
+        return -1;
+    }
 
-        curTime = 0;
-        procIdx = -1;
-
-        readInProcList(fname, procList);
-        numProc = procList.size();
+    readInWorkload(fname, procList);
+    numProc = procList.size();
 
-        //output the header for the run table
-        cout << "\nStarting simulation\n"
-            << "   O: Process scheduled\n"
-            << "   X: Process completed\n"
-            << "   !: Completed process scheduled more time than needed\n\n"
-            << "Time ";
-        tempStr = "-----";
-        for(int i = 0; i < numProc; ++i)
+    if(compare)
+    {
+        if(timeQuantum < 1 || highQuantum < 1)
+        {
+            cout << "INVALID QUANTA\n\n";
+            return -1;
+        }
+        comparePolicies(procList, timeQuantum, highQuantum, lowQuantum, switchCost, switchCostPerWorkingSet, slices || benchmark);
+        return 0;
+    }
+    if(!tuneObjective.empty())
+    {
+        string error;
+        if(!runTuner(procList, schedChoice, tuneObjective, switchCost, switchCostPerWorkingSet, error))
         {
-            cout << "| " << setw(4) << procList[i].id.substr(0,4) << " ";
-            tempStr += "-------";
+            cerr << error << endl;
+            return -1;
         }
-        cout << "| IDLE |\n" << tempStr << "--------\n";
+        return 0;
+    }
+    if(!whatIfPaths.empty())
+    {
+        runWhatIfs(procList, whatIfPaths, schedChoice, timeQuantum, highQuantum, lowQuantum, switchCost, switchCostPerWorkingSet);
+        return 0;
+    }
 
+    long long time;
+    int lastTime = 0;
+    SwitchModel switches(switchCost, switchCostPerWorkingSet);
+    unique_ptr<MetricsPublisher> metrics;
+    if(!metricsAddress.empty())
+    {
+        metrics.reset(new MetricsPublisher(metricsAddress));
+        if(!metrics->ok())
+        {
+            cerr << "Unable to serve metrics on \"" << metricsAddress << "\" (" << metrics->error() << "), continuing without them" << endl;
+            metrics.reset();
+        }
+    }
+    unique_ptr<ScheduleTimeline> timeline;
+    //the emulation runs the recorded schedule
+    if(!timelinePath.empty() || emulateTickUs > 0)
+        timeline.reset(new ScheduleTimeline);
+    if(online)
+    {
+        //the workload arrives through the admission ring, so the list is rebuilt as it comes in
+        OnlineAdmission admission(dropWhenFull);
+        vector<thread> producers;
+        vector<Process> workload;
+        workload.swap(procList);
+        string error;
+        bool started = startProducers(admission, workload, feeds, producers, error);
         auto start = high_resolution_clock::now();
-        //while not all processes have completed:
-        while(!done)
+        if(started)
+            withFairShare(schedChoice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { lastTime = simulateOnline(sched, admission, procList, switches, metrics.get(), timeline.get()); });
+        auto stop = high_resolution_clock::now();
+        for(auto& t: producers)
+            t.join();
+        if(!started)
         {
-            //get the process to schedule next using the indicated scheduler
-            switch(schedChoice)
-            {
-                //Round Robin
-                case 1:
-                    procIdx = RoundRobin(curTime, procList, timeQuantum);
-                    break;
-                //Shortest Process Next
-                case 2:
-                    procIdx = ShortestProcessNext(curTime,procList);
-                    break;
-                //Shortest Remaining Time
-                case 3:
-                    procIdx = ShortestRemainingTime(curTime,procList);
-                    break;
-                //Highest Response Ratio Next
-                case 4:
-                    procIdx = HighestResponseRatioNext(curTime,procList);
-                    break;
-                //Modified Highest Response Ratio Next
-                case 5:
-                    procIdx = Modified_HRRN(curTime,procList);
-                    break;
-                //First in First Out
-                case 6:
-                    procIdx = FIFO(curTime,procList);
-                    break;
-                //Multilevel Queue
-                case 7:
-                    procIdx = MultilevelQueue(curTime,procList,timeQuantum);
-                    break;
-                //Multilevel Feedback Queue
-                case 8:
-                    procIdx = MultilevelFeedbackQueue(curTime,procList,timeQuantum,highQuantum,lowQuantum);
-                    break;
-            }
+            cerr << error << endl;
+            return -1;
+        }
+        time = duration_cast<microseconds>(stop - start).count();
+        numProc = procList.size();
+        cout << "\nOnline admission: " << admission.pushed() << " arrivals from " << feeds.size() << " producers, "
+             << admission.dropped() << " dropped, " << admission.stalls() << " producer stalls, " << admission.late() << " late\n";
+    }
+    else if(benchmark)
+    {
+        //run the per step dispatch loop, the templated loop and the slice loop on their own
+        //copies of the workload without the run table and report how long each took, the last
+        //two relative to the templated loop; the per step dispatch loop has no fair share, the
+        //other two share between the groups
+        vector<Process> workload = procList;
+        vector<Process> dynamicList = procList;
+        vector<Process> tickList = procList;
+        DynamicDispatch dynamic = {schedChoice, timeQuantum, highQuantum, lowQuantum};
+        auto start = high_resolution_clock::now();
+        simulate(dynamic, dynamicList, false);
+        auto stop = high_resolution_clock::now();
+        long long dynamicTime = duration_cast<microseconds>(stop - start).count();
 
-            //if we were given a valid process index
-            if(procIdx >= 0 && procIdx < procList.size())
-            {
-                //update the details for the scheduled process
-                ++procList[procIdx].timeScheduled;
-                ++procList[procIdx].quantumTime;
-                if(procList[procIdx].totalTimeNeeded == procList[procIdx].timeScheduled)
-                {
-                    procList[procIdx].isDone = true;
-                    procList[procIdx].timeFinished = curTime;
-                }
-            }
-            
-            done = true;
-            // output the row for the time step, denoting which process was selected
-            // also check and see if all processes have finished running yet
-            cout << setw(4) << curTime;
-            done = true;
-            for(int i = 0; i < numProc; ++i)
-            {
-                done = done && procList[i].isDone;
+        start = high_resolution_clock::now();
+        withFairShare(schedChoice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { simulate(sched, tickList, false); });
+        stop = high_resolution_clock::now();
+        long long tickTime = duration_cast<microseconds>(stop - start).count();
 
-                if(i == procIdx)
-                {
-                    if(procList[i].isDone)
-                    {
-                        if(procList[i].timeScheduled > procList[i].totalTimeNeeded)
-                        {
-                            cout << " |   ! ";
-                        }
-                        else
-                        {
-                            cout << " |   X ";
-                        }
-                    }                
-                    else
-                    {
-                        cout << " |   O ";
-                    }
-                }
-                else
-                {
-                    cout << " |     ";
-                }
-            }
-            // output for the IDLE process
-            if(procIdx < 0 || procIdx >= numProc)
-            {
-                cout << " |   O ";
-            }
-            else
-            {
-                cout << " |     ";
-            }
-            cout << " |" << endl;
-            
-            //if we aren't done yet, sleep for a bit and move on to the next time step
-            if(!done)
+        start = high_resolution_clock::now();
+        withFairShare(schedChoice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { lastTime = simulateSlices(sched, procList, switches); });
+        stop = high_resolution_clock::now();
+        time = duration_cast<microseconds>(stop - start).count();
+
+        cout << "\nBenchmark:\n" << setprecision(2) << fixed
+             << "  Per step dispatch: " << dynamicTime << " us\n"
+             << "  Templated policy:  " << tickTime << " us\n"
+             << "  Slice granular:    " << time << " us (" << static_cast<double>(tickTime) / max(time, 1LL) << "x)\n";
+
+        //the group's policies only see the time their group ran, which the two engines split up
+        //differently, so under fair share every policy's slice run is checked against its tick run
+        if(fairShare)
+        {
+            string differs;
+            int checked = 0;
+            for(int choice = 1; choice <= 11; ++choice)
             {
-                //this_thread::sleep_for(sleepTime);
-                ++curTime;
+                //a policy whose quanta weren't given is left out
+                if(((choice == 1 || choice == 7 || choice == 8) && timeQuantum < 1) || (choice == 8 && highQuantum < 1))
+                    continue;
+                ++checked;
+                vector<Process> tickRun = workload, sliceRun = workload;
+                withFairShare(choice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { simulate(sched, tickRun, false); });
+                withFairShare(choice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { simulateSlices(sched, sliceRun); });
+                bool matches = true;
+                for(int i = 0; i < numProc; ++i)
+                    matches = matches && tickRun[i].timeFinished == sliceRun[i].timeFinished;
+                if(!matches)
+                    differs += " " + to_string(choice);
             }
+            cout << "  Fair share:        slice runs " << (differs.empty() ? "match the tick runs for the " + to_string(checked) + " policies checked"
+                                                                         : "DIFFER FROM THE TICK RUNS for policies" + differs) << "\n";
+        }
+
+        //the closed form evaluation, where the policy has one, is checked against the simulation
+        vector<Process> analyticList = procList;
+        SwitchModel free;
+        int analyticLastTime;
+        start = high_resolution_clock::now();
+        bool analytic = !fairShare && evaluateAnalytic(schedChoice, analyticList, free, analyticLastTime);
+        stop = high_resolution_clock::now();
+        if(analytic)
+        {
+            long long analyticTime = duration_cast<microseconds>(stop - start).count();
+            bool matches = analyticLastTime == lastTime;
+            for(int i = 0; i < numProc; ++i)
+                matches = matches && analyticList[i].timeFinished == procList[i].timeFinished;
+            cout << "  Analytic:          " << analyticTime << " us (" << static_cast<double>(tickTime) / max(analyticTime, 1LL) << "x), "
+                 << (matches ? "matches the simulation" : "DIFFERS FROM THE SIMULATION") << "\n";
         }
+    }
+    else if(slices)
+    {
+        auto start = high_resolution_clock::now();
+        //with nothing watching the simulation step by step, a closed form does as well (see analytic.h)
+        if(metrics || timeline || fairShare || !evaluateAnalytic(schedChoice, procList, switches, lastTime))
+            withFairShare(schedChoice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { lastTime = simulateSlices(sched, procList, switches, metrics.get(), timeline.get()); });
+        auto stop = high_resolution_clock::now();
+        time = duration_cast<microseconds>(stop - start).count();
+    }
+    else
+    {
+        auto start = high_resolution_clock::now();
+        withFairShare(schedChoice, timeQuantum, highQuantum, lowQuantum, fairShare.get(), [&](auto& sched) { lastTime = simulate(sched, procList, true, switches, metrics.get(), timeline.get()); });
         auto stop = high_resolution_clock::now();
-        auto t = duration_cast<microseconds>(stop - start);
-        auto time = t.count();
+        time = duration_cast<microseconds>(stop - start).count();
+    }
 
     //its done! output the run statistics
     cout << "\n\nRun Statistics:\n";
 
-    //TODO output the requested run stats
-    double avgTurnAroundTime = 0;
-    double avgNormalTurnAroundTime = 0;
-    int turnAroundTime = 0;
-    double normalTurnAroundTime = 0;
-    cout << "Process | Finish Time | Turnaround Time | Normalized Turnaround Time |" << endl
-         << "----------------------------------------------------------------------" << endl;
-    for(auto & Process: procList)
+    //compute the statistics first (see stats.h), then format them
+    ProcessColumns columns;
+    RunStats stats;
+    columns.load(procList);
+    computeRunStats(columns, stats);
+    double avgTurnAroundTime = stats.meanTurnaround();
+    double avgNormalTurnAroundTime = stats.meanNormalizedTurnaround();
+    //the turnaround is split into CPU time, time spent blocked on IO and time waiting for the CPU
+    double avgCpuWaitTime = stats.meanCpuWait();
+    double avgIoTime = stats.meanIo();
+
+    cout << "Process | Finish Time | Turnaround Time | Normalized Turnaround Time | CPU Wait Time | IO Time |" << endl
+         << "----------------------------------------------------------------------------------------------" << endl;
+    cout << setprecision(2) << fixed;
+    for(int i = 0; i < numProc; ++i)
     {
-        cout << setw(7) << Process.id << " |";
-        cout << setw(12) << (Process.timeFinished + 1) << " |";
+        int turnAroundTime = columns.finish[i] + 1 - columns.start[i];
+        cout << setw(7) << processName(procList[i]) << " |"
+             << setw(12) << (columns.finish[i] + 1) << " |"
+             << setw(16) << turnAroundTime << " |"
+             << setw(27) << static_cast<double>(turnAroundTime) / columns.total[i] << " |"
+             << setw(14) << turnAroundTime - columns.total[i] - columns.io[i] << " |"
+             << setw(8) << columns.io[i] << " |" << endl;
+    }
+    cout << "----------------------------------------------------------------------------------------------" << endl;
+    cout << setw(9) << "Mean |" << setw(14) <<" |" << setw(16) << avgTurnAroundTime << " |" << setw(27) << avgNormalTurnAroundTime << " |"
+         << setw(14) << avgCpuWaitTime << " |" << setw(8) << avgIoTime << " |" << endl;
+    cout << "\nTurnaround time: min " << stats.minTurnaround << ", max " << stats.maxTurnaround
+         << ", standard deviation " << sqrt(stats.turnaroundVariance()) << endl;
 
-        turnAroundTime = ((Process.timeFinished + 1) - Process.startTime);
-        avgTurnAroundTime += turnAroundTime;
+    //only workloads with deadlines get the deadline line
+    DeadlineStats deadlines;
+    computeDeadlineStats(columns, deadlines);
+    if(deadlines.count > 0)
+        cout << "\nDeadlines: " << deadlines.missed << " of " << deadlines.count << " missed (" << 100 * deadlines.missRatio()
+             << "%), tardiness mean " << deadlines.meanTardiness << ", 90th " << deadlines.tardiness90 << ", 99th "
+             << deadlines.tardiness99 << ", max " << deadlines.maxTardiness << endl;
 
-        cout << setw(16) << turnAroundTime << " |";
+    //only workloads with groups get the group table
+    vector<GroupStats> groups;
+    computeGroupStats(columns, groups);
+    if(groups.size() > 1 || (groups.size() == 1 && groups[0].group != 0))
+    {
+        long long cpuTime = 0;
+        for(auto& g: groups)
+            cpuTime += g.cpuTime;
+        cout << "\nGroup | Processes | CPU Share | Throughput | Mean Turnaround | 99th Turnaround | Normalized Turnaround | CPU Wait Time |" << endl
+             << "---------------------------------------------------------------------------------------------------------------------" << endl;
+        for(auto& g: groups)
+            cout << setw(5) << g.group << " |" << setw(10) << g.count << " |" << setw(9) << 100.0 * g.cpuTime / max(cpuTime, 1LL) << "% |"
+                 << setw(11) << setprecision(4) << g.throughput() << setprecision(2) << " |" << setw(16) << g.meanTurnaround << " |"
+                 << setw(16) << g.turnaround99 << " |" << setw(22) << g.meanNormalizedTurnaround << " |" << setw(14) << g.meanCpuWait << " |" << endl;
+    }
 
-        normalTurnAroundTime = ((static_cast<double>(Process.timeFinished + 1) - Process.startTime)/Process.totalTimeNeeded);
-        avgNormalTurnAroundTime += normalTurnAroundTime;
+    //time lost to context switches, as a fraction of the whole run
+    double switchOverhead = switches.totalOverhead() / (lastTime + 1);
+    cout << "\nContext switches: " << switches.count() << ", switch overhead: " << switches.totalOverhead()
+         << " time steps (" << 100 * switchOverhead << "% of the run)" << endl;
 
-        cout << setprecision(2) << fixed;
-        cout << setw(27) << normalTurnAroundTime << " |"; 
-        cout << endl;
+    if(emulateTickUs > 0 && !benchmark)
+    {
+        EmulationResult emulation;
+        string error;
+        if(emulateSchedule(*timeline, procList, emulateTickUs, emulateCores, emulation, error))
+            printEmulation(procList, emulation);
+        else
+            cerr << error << endl;
+    }
+
+    if(!timelinePath.empty())
+    {
+        ofstream trace(timelinePath);
+        writeChromeTrace(trace, *timeline, procList);
+        if(!trace)
+            cerr << "Unable to write the timeline to \"" << timelinePath << "\"" << endl;
     }
-    avgTurnAroundTime /= numProc;
-    avgNormalTurnAroundTime /= numProc;
-    cout << "----------------------------------------------------------------------" << endl;
-    cout << setprecision(2) << fixed;
-    cout << setw(9) << "Mean |" << setw(14) <<" |" << setw(16) << avgTurnAroundTime << " |" << setw(27) << avgNormalTurnAroundTime << " |" << endl;
 
     ofstream output;
     output.open("output.txt",fstream::app);
-    //output >> "Input," >> "Turnaround Time," >> "Normalized Turnaround Time," >> "Runtime,\n"
-    output << input << "," << avgTurnAroundTime << "," << avgNormalTurnAroundTime << "," << time << ",\n";
+    //output >> "Input," >> "Turnaround Time," >> "Normalized Turnaround Time," >> "Runtime," >> "Context Switches," >> "Switch Overhead,\n"
+    output << input << "," << avgTurnAroundTime << "," << avgNormalTurnAroundTime << "," << time << "," << switches.count() << "," << switchOverhead << ",\n";
     output.close();
 
     return 0;
@@ -1,4 +1,4 @@
-#include "schedulers.h"
+#include "policies.h"
 
 void quickSort(int arr[], int low, int high); 
 int partition (int arr[], int low, int high);
@@ -53,64 +53,24 @@ int partition (int arr[], int low, int high)
 }  
 
 
+//the scheduler functions find their own arrivals: any process starting at curTime, or coming
+//back from IO at curTime, is admitted
+template<class Sched, class List>
+static void admitArrivals(Sched& sched, int curTime, List& procList)
+{
+    for(int i = 0, i_end = procList.size(); i < i_end; ++i)
+        if(procList[i].startTime == curTime || (procList[i].readyTime == curTime && procList[i].burstPos > procList[i].extras + 1))
+            sched.admit(i, curTime, procList);
+}
+
 //Round Robin scheduler implementation. In general, this function maintains a double ended queue
 //of processes that are candidates for scheduling (the ready variable) and always schedules
 //the first process on that list, if available (i.e., if the list has members)
 int RoundRobin(const int& curTime, const vector<Process>& procList, const int& timeQuantum)
 {
-    static int timeToNextSched = timeQuantum;  //keeps track of when we should actually schedule a new process
-    static deque<int> ready;  //keeps track of the processes that are ready to be scheduled
-
-    int idx = -1, chk;
-    bool done;
-
-    // first look through the process list and find any processes that are newly ready and
-    // add them to the back of the ready queue
-    for(int i = 0, i_end = procList.size(); i < i_end; ++i)
-    {
-        if(procList[i].startTime == curTime)
-        {
-            ready.push_back(i);
-        }
-    }
-
-    // now take a look the head of the ready queue, and update if needed
-    // (i.e., if we are supposed to schedule now or the process is done)
-    if(timeToNextSched == 0 || procList[ready[0]].isDone)
-    {
-        // the process at the start of the ready queue is being taken off of the
-        // processor
-
-        // if the process isn't done, add it to the back of the ready queue
-        if(!procList[ready[0]].isDone)
-        {
-            ready.push_back(ready[0]);
-        }
-
-        // remove the process from the front of the ready queue and reset the time until
-        // the next scheduling
-        ready.pop_front();
-        timeToNextSched = timeQuantum;
-    }
-
-    // if the ready queue has any processes on it
-    if(ready.size() > 0)
-    {
-        // grab the front process and decrement the time to next scheduling
-        idx = ready[0];
-        --timeToNextSched;
-    }
-    // if the ready queue has no processes on it
-    else
-    {
-        // send back an invalid process index and set the time to next scheduling
-        // value so that we try again next time step
-        idx = -1;
-        timeToNextSched = 0;
-    }
-
-    // return back the index of the process to schedule next
-    return idx;
+    static RoundRobinScheduler<> sched(timeQuantum);
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //Shortest Process Next scheduler implementation. In general, this function maintains a double ended queue
@@ -118,32 +78,9 @@ int RoundRobin(const int& curTime, const vector<Process>& procList, const int& t
 //the shortest process next in the queue. This algorithm in non-preemptive.
 int ShortestProcessNext(const int& curTime, const vector<Process>& procList)
 {
-    static deque<int> ready; //keeps track of the processes that are ready to be scheduled
-    int idx = -1;
-    //add to queue on arrival
-    for(unsigned int i = 0; i < procList.size(); i++)
-        if(procList[i].startTime == curTime)
-            ready.push_back(i);
-    //remove done and resort
-    if((procList[ready[0]].isDone) || (curTime == 0))
-    {
-        if(curTime != 0)
-            ready.pop_front();
-        for(unsigned int i = 0; i < ready.size() - 1; i++) //bubble sort to order queue
-            for(unsigned int j = 0; j < ready.size() - i - 1; j++)
-                if(procList[ready[j]].totalTimeNeeded > procList[ready[j + 1]].totalTimeNeeded)
-                    swap(ready[j], ready[j + 1]);
-        if (ready.size() > 1) //if same swap by arrival time
-            if (procList[ready[0]].totalTimeNeeded == procList[ready[1]].totalTimeNeeded)
-                if (procList[ready[0]].startTime > procList[ready[1]].startTime)
-                    swap(ready[0], ready[1]);
-    }
-
-        
-    if(ready.size() > 0)
-        idx = ready[0];
-
-    return idx;
+    static ShortestProcessNextScheduler sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //Shortest Remaining Time scheduler implementation. In general, this function maintains a double ended queue
@@ -151,70 +88,20 @@ int ShortestProcessNext(const int& curTime, const vector<Process>& procList)
 //the process with the shortest remaining execution time left. This algorithm is preemptive.
 int ShortestRemainingTime(const int& curTime,const vector<Process>& procList)
 {
-    static deque<int> ready; //keeps track of the processes that are ready to be scheduled
-    int idx = -1;
-
-    //add to queue on arrival
-    for(unsigned int i = 0; i < procList.size(); i++)
-        if(procList[i].startTime == curTime)
-            ready.push_back(i);
-    //remove done and resort
-        if(procList[ready[0]].isDone && ready.size())
-            ready.pop_front();
-        for(unsigned int i = 0; i < ready.size() - 1; i++) //bubble sort to order processlist
-            for(unsigned int j = 0; j < ready.size() - i - 1; j++)
-                if(procList[ready[j]].totalTimeNeeded - procList[ready[j]].timeScheduled > procList[ready[j + 1]].totalTimeNeeded - procList[ready[j + 1]].timeScheduled)
-                    swap(ready[j], ready[j + 1]);
-        if (ready.size() > 1) //if same swap by arrival time
-            if (procList[ready[0]].totalTimeNeeded - procList[ready[0]].timeScheduled == procList[ready[1]].totalTimeNeeded - procList[ready[1]].timeScheduled)
-                if (procList[ready[0]].startTime > procList[ready[1]].startTime)
-                    swap(ready[0], ready[1]);
-        
-    if(ready.size() > 0)
-        idx = ready[0];
-
-    return idx;
+    static ShortestRemainingTimeScheduler sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //Highest Response Ratio Next scheduling algorithm. The process with the highest response ratio is ran first.
-//represented as (W+S)/S, where W is waiting time and S is burst time (total CPU time needed).
-// W = waiting time = curTime - process.startTime
-// S = burst time = process.totalTimeNeeded
-
+//represented as (W+S)/S, where W is waiting time and S is burst time (CPU time needed for the current burst).
+// W = waiting time = curTime - process.readyTime
+// S = burst time = cpuBurstTime(process)
 int HighestResponseRatioNext(const int& curTime,const vector<Process>& procList)
 {
-    static deque<int> ready; //keeps track of the processes that are ready to be scheduled
-    int idx = -1;
-   
-    //add to queue on arrival
-    for(unsigned int i = 0; i < procList.size(); i++)
-        if(procList[i].startTime == curTime)
-            ready.push_back(i);
-
-    //remove done processes and resort
-    if((procList[ready[0]].isDone) || (curTime == 0))
-    {
-        if(curTime != 0)
-            ready.pop_front();
-        for(unsigned int i = 0; i < ready.size() - 1; i++) //simple bubble sort
-            for(unsigned int j = 0; j < ready.size() - i - 1; j++)
-                if(getResponseRatio(curTime, procList[ready[j]]) < getResponseRatio(curTime, procList[ready[j + 1]]))
-                    swap(ready[j], ready[j + 1]);
-        if (ready.size() > 1)
-            if (getResponseRatio(curTime, procList[ready[0]]) == getResponseRatio(curTime, procList[ready[1]])) //if same swap by arrival time
-                if (procList[ready[0]].startTime > procList[ready[1]].startTime)
-                    swap(ready[0], ready[1]);
-    }
-    if(ready.size() > 0)
-        idx = ready[0];   
-    return idx;
-}
-
-double getResponseRatio(const int & curTime, const Process & process)
-{
-    double waitTime = curTime - process.startTime;
-    double burstTime = process.totalTimeNeeded;
-    return ((waitTime + burstTime) / burstTime);
+    static HighestResponseRatioNextScheduler sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //Modified Highest Response Ratio Next scheduling algorithm. The process with the highest response ratio and priority is
@@ -223,76 +110,17 @@ double getResponseRatio(const int & curTime, const Process & process)
 //when scheduling. High priority has a '0' bit, and low priority has a '1' bit.
 int Modified_HRRN(const int& curTime,const vector<Process>& procList)
 {
-    static deque<int> ready; //keeps track of the processes that are ready to be scheduled
-    int idx = -1;
-   
-    //add to queue on arrival
-    for(unsigned int i = 0; i < procList.size(); i++)
-        if(procList[i].startTime == curTime)
-            ready.push_back(i);
-
-    //remove done processes and resort
-    if((procList[ready[0]].isDone) || (curTime == 0))
-    {
-        if(curTime != 0)
-            ready.pop_front();
-        for(unsigned int i = 0; i < ready.size() - 1; i++) //simple bubble sort
-            for(unsigned int j = 0; j < ready.size() - i - 1; j++)
-                if(getModifiedResponseRatio(curTime, procList[ready[j]]) < getModifiedResponseRatio(curTime, procList[ready[j + 1]]))
-                    swap(ready[j], ready[j + 1]);
-        if (ready.size() > 1)
-            if (getModifiedResponseRatio(curTime, procList[ready[0]]) == getModifiedResponseRatio(curTime, procList[ready[1]])) //if same swap by arrival time
-                if (procList[ready[0]].startTime > procList[ready[1]].startTime)
-                    swap(ready[0], ready[1]);
-    }
-    if(ready.size() > 0)
-        idx = ready[0];   
-    return idx;
-
-}
-
-//Priority = 0.5 * Priority + 0.5 * Ratio
-double getModifiedResponseRatio(const int & curTime, const Process & process)
-{
-    double waitTime = curTime - process.startTime;
-    double burstTime = process.totalTimeNeeded;
-    double ratio = ((waitTime + burstTime) / burstTime);
-    int priority;
-    if(process.priority == 0)
-        priority = 1;
-    else
-        priority = 0;
-    return ((2 * priority) + (0.5 * ratio));
+    static ModifiedHRRNScheduler sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //First in First out scheduling algorithm. Non-preemptive
 int FIFO(const int& curTime, const vector<Process>& procList)
 {
-    static deque<int> ready; //queue of process that are ready to be scheduled
-    int idx = -1;
-
-    //add process to queue if the startTime of that process is equal to the current time
-    for(int i = 0, i_end = procList.size(); i < i_end; ++i)
-    {
-        if(procList[i].startTime == curTime)
-        {
-            ready.push_back(i);
-            //cout<<"size: "<<ready.size()<<"\n";
-        }
-        
-    }
-
-    if(ready.size() > 0)
-    {
-        if(procList[ready[0]].isDone)
-            ready.pop_front();
-        idx = ready[0];         //set idx to next process
-    }
-    // if the ready queue has no processes on it send back invalid index to represent empty queue
-    else
-        idx = -1;   
-
-    return idx;    
+    static FIFOScheduler sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //Multilevel Queue scheduling algorithm partitions the reqdy queue into several separate queues based
@@ -311,90 +139,9 @@ int FIFO(const int& curTime, const vector<Process>& procList)
 //a lower priority. Note, this does leave the possibility for Starvation!
 int MultilevelQueue(const int& curTime, const vector<Process>& procList,const int& timeQuantum)
 {
-    static int timeToNextSched = timeQuantum;  //keeps track of when we should actually schedule a new process
-    static deque<int> ready; //queue of process that are ready to be scheduled
-    static deque<int> foreground; //queue of foreground processes
-    static deque<int> background; //queue of background processes
-    int idx = -1;
-
-    //add process to queue if the startTime of that process is equal to the current time
-    //if the process that is ready has a larger priority (smaller number) than the following process
-    //push it to the front of the queue
-    for(int i = 0, i_end = procList.size(); i < i_end; ++i)
-    {
-        if(procList[i].startTime == curTime)
-        {
-            if(procList[i].priority == 0)
-            {
-                if(foreground.size() == 0)
-                    foreground.push_back(i);
-                else if(procList[i].priority < procList[foreground[0]].priority)
-                    foreground.push_front(i);
-                else if(procList[i].priority >= procList[foreground[0]].priority)
-                    foreground.push_back(i);
-            }
-             else
-            {
-                if(background.size() == 0)
-                    background.push_back(i);
-                else if(procList[i].priority < procList[background[0]].priority)
-                    background.push_front(i);
-                else if(procList[i].priority >= procList[background[0]].priority)
-                    background.push_back(i);
-            }
-        }
-    }/*
-                                    for(int j=0; j< foreground.size(); ++j)
-                cout<<procList[foreground[j]].id<<" ";
-            cout<<"\n";
-                                for(int j=0; j< background.size(); ++j)
-                cout<<procList[background[j]].id<<" ";
-            cout<<"\n";*/
-
-    //FOREGROUND PROCESSES (HIGH PRIORITY ROUND ROBIN ALGORITHM)
-    if(foreground.size() > 0)
-    {
-        if((timeToNextSched == 0) || (procList[foreground[0]].isDone))
-        {
-            if(!procList[foreground[0]].isDone)
-            {
-                foreground.push_back(foreground[0]);
-            }
-            foreground.pop_front();
-            timeToNextSched = timeQuantum;
-        }
-        // if the ready queue has any processes on it
-        if(foreground.size() > 0)
-        {
-            // grab the front process and decrement the time to next scheduling
-            idx = foreground[0];
-            --timeToNextSched;
-            return idx;
-        }
-        // if the ready queue has no processes on it
-        else
-        {
-            // send back an invalid process index and set the time to next scheduling
-            // value so that we try again next time step
-            idx = -1;
-            timeToNextSched = 0;
-            if(background.size() > 0)
-                idx = background[0];
-        }
-    }
-
-    //BACKGROUND PROCESSES (LOW PRIORITY FIRST IN FIRST OUT ALGORITHM)
-    else
-    {
-        if(procList[background[0]].isDone)
-            background.pop_front();
-        idx = background[0];         //set idx to next process       
-    }
-
-    if(background.size() == 0 && foreground.size() == 0)
-        idx = -1;
-
-    return idx;       
+    static MultilevelQueueScheduler<> sched(timeQuantum);
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
 }
 
 //Multilevel Feedback Queue allows a process to move between queues. This is based on the CPU burst of the process.
@@ -405,8 +152,9 @@ int MultilevelQueue(const int& curTime, const vector<Process>& procList,const in
 //Like before, high priority will be represented by the bit '0' and high priority is represented by a '1'
 //This is a simplified version as there are multiple levels of priority in a real system.
 
-//For this simulation, a process's CPU burst time will have a random amount of time added to it (by no more than 20)
-//This will represent the realistic possibility that a program takes much longer than its estimated burst time.
+//A process's CPU burst can take much longer or shorter than its estimated burst time. Rather than adding random
+//time to the bursts here, which would change the workload in place for every later run, experiments model it
+//with perturbed replicas of the workload (burstNoise, see experiment.h and workloadOverlay.h).
 //The user can give a "Switch Time" for both the high-priority and low-priority queus. This time is another
 //time quantum. The seperate switch times allow the user to specify longer wait times before switching queues
 //for both high and low priority processes.
@@ -414,113 +162,33 @@ int MultilevelQueue(const int& curTime, const vector<Process>& procList,const in
 //High priority will retain a Round Robin algorithm and low priority will keep a FIFO algorithm for completion.
 int MultilevelFeedbackQueue(const int& curTime, vector<Process>& procList,const int& timeQuantum,const int& highQuantum, const int&lowQuantum)
 {
-    static int timeToNextSched = timeQuantum;  //keeps track of when we should actually schedule a new process
-    static deque<int> ready; //queue of process that are ready to be scheduled
-    static deque<int> foreground; //queue of foreground processes
-    static deque<int> background; //queue of background processes
-    bool queueChange = false;     //Marks the need for a queue change based on priority quantums
-    srand(time(NULL));
-    int idx = -1;
-
-    //add process to queue if the startTime of that process is equal to the current time
-    //if the process that is ready has a larger priority (smaller number) than the following process
-    //push it to the front of the queue
-    for(int i = 0, i_end = procList.size(); i < i_end; ++i)
-    {
-        if((procList[i].startTime == curTime) || (queueChange == true))
-        {
-            if(procList[i].priority == 0)
-            {
-                if(foreground.size() == 0)
-                    foreground.push_back(i);
-                else if(procList[i].priority < procList[foreground[0]].priority)
-                    foreground.push_front(i);
-                else if(procList[i].priority >= procList[foreground[0]].priority)
-                    foreground.push_back(i);
-                //procList[foreground[0]].totalTimeNeeded += (rand() % 20);
-            }
-             else
-            {
-                if(background.size() == 0)
-                    background.push_back(i);
-                else if(procList[i].priority < procList[background[0]].priority)
-                    background.push_front(i);
-                else if(procList[i].priority >= procList[background[0]].priority)
-                    background.push_back(i);
-                //procList[background[0]].totalTimeNeeded += (rand() % 20);
-            }
-        }
-    }
-    if(foreground.size() > 0)
-    {
-        if(!procList[foreground[0]].isDone)
-        {
-            if((procList[foreground[0]].quantumTime % highQuantum == 0) && (procList[foreground[0]].quantumTime != 0))
-            {
-                procList[foreground[0]].quantumTime = 0;
-                background.push_back(foreground[0]); //move to lower queue
-                foreground.pop_front(); //remove from high-priority queue
-            }
-        }
-    }
-    for(int i=0; i<background.size(); i++)
-        procList[background[i]].waitTime++;
-    if(background.size() > 0)
-    {
-        if(!procList[background[0]].isDone)
-        {
-            if((procList[background[0]].waitTime == lowQuantum) && (procList[background[0]].quantumTime != 0))
-            {
-                procList[background[0]].waitTime = 0;
-                procList[background[0]].quantumTime = 0;
-                foreground.push_back(background[0]); //move to higher queue
-                background.pop_front(); //remove from low-priority queue
-            }
-        }
-    }
-
-    //FOREGROUND PROCESSES (HIGH PRIORITY ROUND ROBIN ALGORITHM)
-    if(foreground.size() > 0)
-    {
-        if((timeToNextSched == 0) || (procList[foreground[0]].isDone))
-        {
-            if(!procList[foreground[0]].isDone)
-            {
-                foreground.push_back(foreground[0]);
-            }
-            foreground.pop_front();
-            timeToNextSched = timeQuantum;
-        }
-        // if the ready queue has any processes on it
-        if(foreground.size() > 0)
-        {
-            // grab the front process and decrement the time to next scheduling
-            idx = foreground[0];
-            --timeToNextSched;
-            return idx;
-        }
-        // if the ready queue has no processes on it
-        else
-        {
-            // send back an invalid process index and set the time to next scheduling
-            // value so that we try again next time step
-            idx = -1;
-            timeToNextSched = 0;
-            if(background.size() > 0)
-                idx = background[0];
-        }
-    }
+    static MultilevelFeedbackQueueScheduler<> sched(timeQuantum, highQuantum, lowQuantum);
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
+}
 
-    //BACKGROUND PROCESSES (LOW PRIORITY FIRST IN FIRST OUT ALGORITHM)
-    else
-    {
-        if(procList[background[0]].isDone)
-            background.pop_front();
-        idx = background[0];         //set idx to next process       
-    }
+//Earliest Deadline First runs the ready process whose deadline comes first. The preemptive version
+//switches as soon as a process with an earlier deadline arrives, the non-preemptive one only when
+//the running process completes or blocks. Processes without a deadline wait for those with one.
+int EarliestDeadlineFirst(const int& curTime, const vector<Process>& procList)
+{
+    static EarliestDeadlineFirstScheduler<true> sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
+}
 
-    if(background.size() == 0 && foreground.size() == 0)
-        idx = -1;
+int NonPreemptiveEarliestDeadlineFirst(const int& curTime, const vector<Process>& procList)
+{
+    static EarliestDeadlineFirstScheduler<false> sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
+}
 
-    return idx;        
-}
\ No newline at end of file
+//Least Laxity First runs the ready process with the least slack: the time to its deadline less the
+//CPU time it still needs
+int LeastLaxityFirst(const int& curTime, const vector<Process>& procList)
+{
+    static LeastLaxityFirstScheduler sched;
+    admitArrivals(sched, curTime, procList);
+    return sched.next(curTime, procList);
+}
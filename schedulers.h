@@ -2,32 +2,271 @@
 #define SCHEDULERS_H
 
 #include<vector>  //process vector
-#include<deque>   //for ready double ended queue
 #include<fstream>  // file i/o
 #include<iostream> // cerr
+#include<sstream>  // burst columns
+#include<algorithm> // max
+#include<cctype>    // isdigit
+#include<climits>   // INT_MAX
 #include<stdlib.h>
 #include<time.h>
+#include "idArena.h"
 
 using namespace std;
 
+//Burst lists of every process, back to back. A process with a list has the offset of its entry,
+//which holds its working set size followed by its alternating CPU and IO bursts (first and last
+//are CPU) and END_OF_BURSTS; the words before the entry hold its relative deadline, its group and
+//its burst estimate scale, nearest first. Offset 0 means the process has none of them: a single
+//CPU burst of totalTimeNeeded, no working set, no deadline, group 0 and exact estimates. Like the
+//id arena it is filled while loading a workload.
+//The C API (see SchedulerLibrary/schedulerApi.h) is built with SCHEDULER_LIBRARY defined: each of
+//its scheduler instances has a pool of its own, which it sets as its thread's pool while it works,
+//so instances on other threads don't share one.
+#ifdef SCHEDULER_LIBRARY
+inline vector<int>*& threadBurstPool()
+{
+    static thread_local vector<int>* pool = nullptr;
+    return pool;
+}
+
+inline vector<int>& burstPool()
+{
+    static vector<int> pool(1, 0);
+    vector<int>* own = threadBurstPool();
+    return own ? *own : pool;
+}
+#else
+inline vector<int>& burstPool()
+{
+    static vector<int> pool(1, 0);
+    return pool;
+}
+#endif
+
+//marks the end of a process's bursts in the pool
+const int END_OF_BURSTS = -1;
+
+//The simulation keeps one record per process, so the record is kept compact: 48 bytes with
+//nothing on the heap, against 64 for the original record (a string id, seven ints and a flag), while it
+//also carries the burst, IO and ready time state. The given data (id, start, total, priority)
+//takes the first 16 bytes and the rest is run state. The id is interned in processIds() and the
+//bursts are kept in burstPool().
 struct Process
 {
-    Process() : isDone(false), totalTimeNeeded(-1), timeScheduled(0), startTime(-1), timeFinished(-1) {}
+    Process() : id(0), startTime(-1), totalTimeNeeded(-1), priority(0), isDone(false), isBlocked(false), timeScheduled(0), quantumTime(0),
+                timeFinished(-1), waitTime(0), burstEnd(-1), readyTime(-1), extras(0), burstPos(0) {}
 
     // Given data
-    string id;            //The process id
+    StringHandle id;      //The process id, see processIds()
     int startTime;        //The time at which the process becomes available for scheduling
     int totalTimeNeeded;  //The total amount of time needed by the process
-    int priority;         //0-9: 0-4 (high priority foreground process) 5-9 (lower priority background process)
+    signed char priority; //0-9: 0-4 (high priority foreground process) 5-9 (lower priority background process)
 
     // Process details
     bool isDone;          //Indicates if the process is complete
+    bool isBlocked;       //Indicates if the process is waiting for IO
     int timeScheduled;    //The amount of time the process has been scheduled so far
     int quantumTime;      //time spent on priority quantum
     int timeFinished;     //The time that the process completed
     int waitTime;         //time process has been waiting to be scheduled
+    int burstEnd;         //value of timeScheduled at which the current CPU burst ends
+    int readyTime;        //time the process last became ready (arrival or IO completion)
+    uint32_t extras;      //offset of the process's working set and bursts in burstPool(), 0 if none
+    uint32_t burstPos;    //offset of the current CPU burst in burstPool(), 0 without bursts
 };
+static_assert(sizeof(Process) == 48, "Process records are meant to stay compact");
+
+//the process's id as text
+inline string_view processName(const Process& p)
+{
+    return processIds()[p.id];
+}
+
+//sets the process's id, interning it
+inline void setProcessName(Process& p, string_view name)
+{
+    p.id = processIds().intern(name);
+}
+
+//estimate scale of exact estimates, see setBursts()
+const int EXACT_ESTIMATE = 1 << 16;
+
+//Stores the process's working set size, bursts (alternating CPU and IO, first and last are
+//CPU; empty for a single CPU burst), deadline relative to its start time (0 for none), group
+//(tenant, 0 for the default one) and estimate scale in the burst pool. The shortest first,
+//response ratio and laxity policies order by estimates of the CPU bursts, the true lengths times
+//estimateScale / EXACT_ESTIMATE; the processes still run for their true lengths.
+inline void setBursts(Process& p, int workingSet, const vector<int>& bursts, int deadline = 0, int group = 0,
+                      int estimateScale = EXACT_ESTIMATE)
+{
+    if(workingSet == 0 && bursts.empty() && deadline <= 0 && group <= 0 && estimateScale == EXACT_ESTIMATE)
+        return;
+    vector<int>& pool = burstPool();
+    pool.push_back(max(estimateScale, 0));
+    pool.push_back(max(group, 0));
+    pool.push_back(max(deadline, 0));
+    p.extras = pool.size();
+    pool.push_back(workingSet);
+    pool.insert(pool.end(), bursts.begin(), bursts.end());
+    pool.push_back(END_OF_BURSTS);
+}
+
+//size of the process's working set, for the context switch cost
+inline int workingSet(const Process& p)
+{
+    return p.extras ? burstPool()[p.extras] : 0;
+}
+
+//time after its start by which the process should complete, 0 if it has no deadline
+inline int relativeDeadline(const Process& p)
+{
+    return p.extras ? burstPool()[p.extras - 1] : 0;
+}
+
+//the group (tenant) the process belongs to, 0 for the default one
+inline int processGroup(const Process& p)
+{
+    return p.extras ? burstPool()[p.extras - 2] : 0;
+}
+
+//scale of the process's burst estimates, EXACT_ESTIMATE if they are the true lengths
+inline int estimateScale(const Process& p)
+{
+    return p.extras ? burstPool()[p.extras - 3] : EXACT_ESTIMATE;
+}
+
+//length scaled by the estimate scale, at least one step
+inline long long estimate(const Process& p, long long length)
+{
+    int scale = estimateScale(p);
+    return scale == EXACT_ESTIMATE ? length : max((length * scale + EXACT_ESTIMATE / 2) / EXACT_ESTIMATE, 1LL);
+}
+
+//Time by which the process should complete, INT_MAX if it has no deadline. It meets the deadline
+//if it finishes by then, i.e. timeFinished + 1 <= deadline.
+inline int absoluteDeadline(const Process& p)
+{
+    int relative = relativeDeadline(p);
+    return relative > 0 ? p.startTime + relative : INT_MAX;
+}
 
+//the process can be given the processor (not done and not blocked on IO)
+inline bool isRunnable(const Process& p)
+{
+    return !p.isDone && !p.isBlocked;
+}
+
+//length of the process's current CPU burst
+inline int cpuBurstTime(const Process& p)
+{
+    return p.burstPos ? burstPool()[p.burstPos] : p.totalTimeNeeded;
+}
+
+//time the process still needs to finish its current CPU burst
+inline int cpuBurstLeft(const Process& p)
+{
+    return p.burstEnd - p.timeScheduled;
+}
+
+//length of the IO burst after the current CPU burst, END_OF_BURSTS if it is the last CPU burst
+inline int nextIoBurst(const Process& p)
+{
+    return p.burstPos ? burstPool()[p.burstPos + 1] : END_OF_BURSTS;
+}
+
+//estimated length of the process's current CPU burst
+inline int estimatedBurstTime(const Process& p)
+{
+    return static_cast<int>(estimate(p, cpuBurstTime(p)));
+}
+
+//Estimated time the process still needs to finish its current CPU burst, its estimated length
+//less the time it ran; negative once it has run past its estimate
+inline int estimatedBurstLeft(const Process& p)
+{
+    return cpuBurstLeft(p) + estimatedBurstTime(p) - cpuBurstTime(p);
+}
+
+//time the process has spent blocked on IO so far
+inline int ioTime(const Process& p)
+{
+    int total = 0;
+    if(p.burstPos)
+        for(uint32_t i = p.extras + 1; i < p.burstPos; i += 2)
+            total += burstPool()[i + 1];
+    return total;
+}
+
+//puts the process at the start of its first CPU burst, ready at its start time
+inline void resetBursts(Process& p)
+{
+    p.burstPos = (p.extras && burstPool()[p.extras + 1] != END_OF_BURSTS) ? p.extras + 1 : 0;
+    p.burstEnd = cpuBurstTime(p);
+    p.readyTime = p.startTime;
+    p.isBlocked = false;
+}
+
+//moves the process past its IO burst to its next CPU burst
+inline void startNextBurst(Process& p)
+{
+    p.burstPos += 2;
+    p.burstEnd = p.timeScheduled + burstPool()[p.burstPos];
+}
+
+
+//Reads the columns after "id start total priority": optionally the process's bursts "cpu io cpu
+//... cpu" (with bursts, the total is the sum of the CPU bursts), its working set size as
+//"ws=<size>", its deadline, in time steps after its start, as "dl=<steps>" and its group as
+//"grp=<group>". bursts is left as setBursts() takes it, empty for a single CPU burst.
+inline void readBurstColumns(const string& rest, int& totalTimeNeeded, int& workingSet, int& deadline, int& group, vector<int>& bursts)
+{
+    istringstream burstIn(rest);
+    string token;
+    int burst, numBursts = 0;
+    bursts.clear();
+    while(burstIn >> token)
+    {
+        if(token.compare(0, 3, "ws=") == 0)
+        {
+            workingSet = atoi(token.c_str() + 3);
+            continue;
+        }
+        if(token.compare(0, 3, "dl=") == 0)
+        {
+            deadline = max(atoi(token.c_str() + 3), 0);
+            continue;
+        }
+        if(token.compare(0, 4, "grp=") == 0)
+        {
+            group = max(atoi(token.c_str() + 4), 0);
+            continue;
+        }
+        if(!isdigit(static_cast<unsigned char>(token[0])) && token[0] != '-')
+            break;
+        burst = atoi(token.c_str());
+        if(numBursts++ % 2 == 1)
+            bursts.push_back(burst);
+        else if(numBursts > 1 && bursts.back() <= 0)
+        {
+            //no IO in between, so it is all one CPU burst
+            bursts.pop_back();
+            bursts.back() += max(burst, 1);
+        }
+        else
+            bursts.push_back(max(burst, 1));
+    }
+    if(bursts.size() % 2 == 0 && !bursts.empty())
+        bursts.pop_back();    //trailing IO burst
+    if(!bursts.empty())
+    {
+        totalTimeNeeded = 0;
+        for(unsigned int i = 0; i < bursts.size(); i += 2)
+            totalTimeNeeded += bursts[i];
+    }
+    if(bursts.size() == 1)
+        bursts.clear();
+}
 
 inline void readInProcList(const string& fname, vector<Process>& procList)
 {
@@ -40,16 +279,25 @@ inline void readInProcList(const string& fname, vector<Process>& procList)
         exit(-1);
     }
 
+    //each line is "id start total priority", optionally followed by the process's bursts, its
+    //working set size, its deadline and its group (see readBurstColumns())
+    string name, rest;
+    vector<int> bursts;
     in >> numProcs;
     procList.resize(numProcs);
     for(auto& p:procList)
     {
-        in >> p.id >> p.startTime >> p.totalTimeNeeded >> p.priority;
+        int priority = 0, workingSet = 0, deadline = 0, group = 0;
+        in >> name >> p.startTime >> p.totalTimeNeeded >> priority;
+        setProcessName(p, name);
+        p.priority = priority;
+        getline(in, rest);
+        readBurstColumns(rest, p.totalTimeNeeded, workingSet, deadline, group, bursts);
+        setBursts(p, workingSet, bursts, deadline, group);
     }
     in.close();
 }
 
-//given
 int RoundRobin(const int& curTime, const vector<Process>& procList, const int& timeQuantum);
 
 //shortest job first algorithm
@@ -65,14 +313,32 @@ int ShortestRemainingTime(const int& curTime,const vector<Process>& procList);
 int HighestResponseRatioNext(const int& curTime,const vector<Process>& procList);
 
 //returns double representing the response ratio of the given process
-double getResponseRatio(const int & curTime, const Process & process);
+//(W is the time since the process last became ready, S the estimate of its current CPU burst)
+inline double getResponseRatio(const int & curTime, const Process & process)
+{
+    double waitTime = curTime - process.readyTime;
+    double burstTime = estimatedBurstTime(process);
+    return ((waitTime + burstTime) / burstTime);
+}
 
 //Modified Highest response ratio next algorithm
 //preemptive
 int Modified_HRRN(const int& curTime,const vector<Process>& procList);
 
 //return double representing the modified response ration of the given process
-double getModifiedResponseRatio(const int & curTime, const Process & process);
+//Priority = 0.5 * Priority + 0.5 * Ratio
+inline double getModifiedResponseRatio(const int & curTime, const Process & process)
+{
+    double waitTime = curTime - process.readyTime;
+    double burstTime = estimatedBurstTime(process);
+    double ratio = ((waitTime + burstTime) / burstTime);
+    int priority;
+    if(process.priority == 0)
+        priority = 1;
+    else
+        priority = 0;
+    return ((2 * priority) + (0.5 * ratio));
+}
 
 //First in First Out scheduling algorithm
 //non-preemptive
@@ -84,4 +350,15 @@ int MultilevelQueue(const int& curTime, const vector<Process>& procList, const i
 //Multilevel Feedback Queue scheduling algorithm
 int MultilevelFeedbackQueue(const int& curTime, vector<Process>& procList, const int& timeQuantum,const int& highQuantum, const int&lowQuantum);
 
+//Earliest Deadline First scheduling algorithm
+//preemptive: an arrival with an earlier deadline interrupts the running process
+int EarliestDeadlineFirst(const int& curTime, const vector<Process>& procList);
+
+//non-preemptive Earliest Deadline First
+int NonPreemptiveEarliestDeadlineFirst(const int& curTime, const vector<Process>& procList);
+
+//Least Laxity First scheduling algorithm
+//preemptive
+int LeastLaxityFirst(const int& curTime, const vector<Process>& procList);
+
 #endif
\ No newline at end of file
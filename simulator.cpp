@@ -0,0 +1,78 @@
+#include<iomanip>  // setw
+#include "simulator.h"
+
+vector<int> arrivalOrder(const vector<Process>& procList)
+{
+    vector<int> order(procList.size());
+    for(unsigned int i = 0; i < order.size(); ++i)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b)
+    {
+        return procList[a].startTime < procList[b].startTime;
+    });
+    return order;
+}
+
+void printTableHeader(const vector<Process>& procList)
+{
+    string tempStr = "-----";
+
+    cout << "\nStarting simulation\n"
+        << "   O: Process scheduled\n"
+        << "   X: Process completed\n"
+        << "   !: Completed process scheduled more time than needed\n"
+        << "   S: Context switch to the process\n\n"
+        << "Time ";
+    for(auto& p: procList)
+    {
+        cout << "| " << setw(4) << processName(p).substr(0,4) << " ";
+        tempStr += "-------";
+    }
+    cout << "| IDLE |\n" << tempStr << "--------\n";
+}
+
+void printTableRow(int curTime, int procIdx, const vector<Process>& procList, bool switching)
+{
+    int numProc = procList.size();
+
+    cout << setw(4) << curTime;
+    for(int i = 0; i < numProc; ++i)
+    {
+        if(i == procIdx && switching)
+        {
+            cout << " |   S ";
+        }
+        else if(i == procIdx)
+        {
+            if(procList[i].isDone)
+            {
+                if(procList[i].timeScheduled > procList[i].totalTimeNeeded)
+                {
+                    cout << " |   ! ";
+                }
+                else
+                {
+                    cout << " |   X ";
+                }
+            }
+            else
+            {
+                cout << " |   O ";
+            }
+        }
+        else
+        {
+            cout << " |     ";
+        }
+    }
+    // output for the IDLE process
+    if(procIdx < 0 || procIdx >= numProc)
+    {
+        cout << " |   O ";
+    }
+    else
+    {
+        cout << " |     ";
+    }
+    cout << " |" << endl;
+}
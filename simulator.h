@@ -0,0 +1,361 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include<utility> // integer_sequence
+#include<type_traits> // is_same
+#include "policies.h"
+#include "timerWheel.h"
+#include "switchModel.h"
+#include "metrics.h"
+#include "timeline.h"
+
+//output the header for the run table
+void printTableHeader(const vector<Process>& procList);
+
+//output the row for the time step, denoting which process was selected (or switched to)
+void printTableRow(int curTime, int procIdx, const vector<Process>& procList, bool switching = false);
+
+//process indices ordered by start time, ties in list order
+vector<int> arrivalOrder(const vector<Process>& procList);
+
+//Charges length time steps run from curTime to process idx. A process reaching the end of its CPU
+//burst completes, or blocks in the wheel until its next IO burst is over. Returns true if the
+//process completed.
+inline bool chargeRun(vector<Process>& procList, int idx, int curTime, int length, TimerWheel& blocked)
+{
+    Process& p = procList[idx];
+    p.timeScheduled += length;
+    p.quantumTime += length;
+    if(p.isDone || p.timeScheduled < p.burstEnd)
+        return false;
+    int io = nextIoBurst(p);
+    if(io != END_OF_BURSTS)
+    {
+        p.isBlocked = true;
+        blocked.insert(idx, curTime + length + io);
+        return false;
+    }
+    p.isDone = true;
+    p.timeFinished = curTime + length - 1;
+    return true;
+}
+
+//how a run charged with chargeRun() ended, for the timeline
+inline RunReason runOutcome(const Process& p)
+{
+    return p.isDone ? RunReason::COMPLETED : p.isBlocked ? RunReason::BLOCKED : RunReason::PREEMPTED;
+}
+
+//Hands the processes whose IO completed by curTime back to the scheduler, starting their next CPU
+//burst. The scheduler's clock runs overhead steps behind the simulated time (see simulate()).
+template<class Policy>
+void wakeBlocked(Policy& policy, TimerWheel& blocked, int curTime, int overhead, vector<Process>& procList)
+{
+    blocked.expire(curTime, [&](int idx, int wakeTime)
+    {
+        Process& p = procList[idx];
+        p.isBlocked = false;
+        startNextBurst(p);
+        p.readyTime = wakeTime - overhead;
+        policy.admit(idx, curTime - overhead, procList);
+    });
+}
+
+//hands the scheduler process idx, which arrived by curTime
+template<class Policy>
+void admitArrival(Policy& policy, int idx, int curTime, int overhead, vector<Process>& procList)
+{
+    procList[idx].readyTime = procList[idx].startTime - overhead;
+    policy.admit(idx, curTime - overhead, procList);
+}
+
+//Simulation tick loop. The policy is a template parameter so the scheduler's per tick decision
+//is resolved at compile time and inlined into the loop. Runs until every process has completed
+//and returns the last simulated time.
+//Each switch to another process first spends the switch cost, during which nothing runs. The
+//scheduler doesn't see that time pass: its clock is the simulated time less the switch overhead
+//so far, so a quantum only counts the time the process actually ran.
+//If metrics is given, the loop publishes its progress to it (see metrics.h), and if timeline is
+//given it records the schedule in it (see timeline.h).
+template<class Policy>
+int simulate(Policy& policy, vector<Process>& procList, bool showTable, SwitchModel& switches, MetricsPublisher* metrics = nullptr,
+             ScheduleTimeline* timeline = nullptr)
+{
+    int curTime = 0, procIdx, numDone = 0, overhead = 0;
+    int numProc = procList.size();
+    vector<int> order = arrivalOrder(procList);
+    unsigned int arrived = 0;
+    TimerWheel blocked;   //processes waiting for IO
+
+    for(auto& p: procList)
+        resetBursts(p);
+    if(showTable)
+        printTableHeader(procList);
+
+    while(true)
+    {
+        //hand the scheduler the processes that are newly ready
+        while(arrived < order.size() && procList[order[arrived]].startTime <= curTime)
+            admitArrival(policy, order[arrived++], curTime, overhead, procList);
+        wakeBlocked(policy, blocked, curTime, overhead, procList);
+
+        //get the process to schedule next
+        procIdx = policy.next(curTime - overhead, procList);
+
+        //if we were given a valid process index, update the details for the scheduled process
+        if(procIdx >= 0 && procIdx < numProc)
+        {
+            for(int delay = switches.dispatch(procIdx, procList[procIdx]); delay > 0; --delay, ++curTime, ++overhead)
+            {
+                if(showTable)
+                    printTableRow(curTime, procIdx, procList, true);
+                if(timeline)
+                    timeline->record(procIdx, curTime, 1, RunReason::SWITCH);
+            }
+            if(chargeRun(procList, procIdx, curTime, 1, blocked))
+            {
+                ++numDone;
+                if(metrics)
+                    metrics->complete(curTime + 1 - procList[procIdx].startTime);
+            }
+            if(timeline)
+                timeline->record(procIdx, curTime, 1, runOutcome(procList[procIdx]));
+        }
+
+        if(showTable)
+            printTableRow(curTime, procIdx, procList);
+        if(metrics && metrics->tick())
+            metrics->publish(curTime, numDone, numProc, blocked.size(), policy);
+
+        //if we aren't done yet move on to the next time step
+        if(numDone >= numProc)
+            break;
+        ++curTime;
+    }
+    if(metrics)
+        metrics->publish(curTime, numDone, numProc, blocked.size(), policy, true);
+    return curTime;
+}
+
+//simulate() with context switches for free
+template<class Policy>
+int simulate(Policy& policy, vector<Process>& procList, bool showTable)
+{
+    SwitchModel free;
+    return simulate(policy, procList, showTable, free);
+}
+
+//Where the slice loop is between two decisions, apart from the processes, the policy, the switch
+//model and the blocked processes. Together with those it is all a run needs to continue, so a
+//run can be checkpointed and resumed (see incremental.h).
+struct SliceLoopState
+{
+    int curTime = 0;
+    int lastTime = 0;
+    int numDone = 0;
+    int overhead = 0;
+    unsigned int arrived = 0;   //processes handed to the scheduler, a prefix of the arrival order
+    long long decisions = 0;    //scheduler decisions so far
+};
+
+//continueSlices() observer that does nothing
+struct NoSliceObserver
+{
+    template<class Policy>
+    void operator()(const SliceLoopState&, const TimerWheel&, const Policy&, const SwitchModel&, const vector<Process>&) {}
+};
+
+//The slice loop of simulateSlices(), run from state until every process has completed. order is
+//arrivalOrder(procList) and blocked holds the processes waiting for IO. Before each decision the
+//loop brings state up to date and calls observer(state, blocked, policy, switches, procList).
+template<class Policy, class Observer = NoSliceObserver>
+int continueSlices(Policy& policy, vector<Process>& procList, const vector<int>& order, SliceLoopState& state, TimerWheel& blocked,
+                   SwitchModel& switches, MetricsPublisher* metrics = nullptr, ScheduleTimeline* timeline = nullptr,
+                   Observer observer = Observer())
+{
+    int curTime = state.curTime, lastTime = state.lastTime, numDone = state.numDone, overhead = state.overhead;
+    int numProc = procList.size();
+    unsigned int arrived = state.arrived;
+    long long decisions = state.decisions;
+
+    while(numDone < numProc)
+    {
+        if(!is_same<Observer, NoSliceObserver>::value)
+        {
+            state = SliceLoopState{curTime, lastTime, numDone, overhead, arrived, decisions};
+            observer(state, blocked, policy, switches, procList);
+        }
+        ++decisions;
+        while(arrived < order.size() && procList[order[arrived]].startTime <= curTime)
+            admitArrival(policy, order[arrived++], curTime, overhead, procList);
+        wakeBlocked(policy, blocked, curTime, overhead, procList);
+        //a wakeup can preempt like an arrival does
+        int nextWakeup = blocked.nextExpiry();
+        int nextArrival = arrived < order.size() ? procList[order[arrived]].startTime : NEVER;
+        nextArrival = min(nextArrival, nextWakeup);
+
+        Slice slice = policy.nextSlice(curTime - overhead, nextArrival == NEVER ? NEVER : nextArrival - overhead, procList);
+        if(slice.idx < 0 || slice.idx >= numProc)
+        {
+            //idle until the next arrival or wakeup; with neither left nothing can finish
+            if(nextArrival == NEVER)
+                break;
+            lastTime = curTime;
+            curTime = nextArrival;
+            continue;
+        }
+
+        //the slice can be cut short by an arrival or wakeup, but only after its first step,
+        //since the tick loop doesn't look at arrivals during a switch either; a decision runs for
+        //at least a step, as in the tick loop, even from a policy given a quantum below 1
+        int preemptAt = slice.preemptAt == NEVER ? NEVER : slice.preemptAt + overhead;
+        int delay = switches.dispatch(slice.idx, procList[slice.idx]);
+        if(timeline && delay > 0)
+            timeline->record(slice.idx, curTime, delay, RunReason::SWITCH);
+        curTime += delay;
+        overhead += delay;
+        int length = max(min(slice.length, min(preemptAt, nextWakeup) - curTime), 1);
+
+        if(chargeRun(procList, slice.idx, curTime, length, blocked))
+        {
+            ++numDone;
+            if(metrics)
+                metrics->complete(curTime + length - procList[slice.idx].startTime);
+        }
+        if(timeline)
+            timeline->record(slice.idx, curTime, length, runOutcome(procList[slice.idx]));
+        curTime += length;
+        lastTime = curTime - 1;
+        if(metrics && metrics->tick())
+            metrics->publish(lastTime, numDone, numProc, blocked.size(), policy);
+    }
+    if(metrics)
+        metrics->publish(lastTime, numDone, numProc, blocked.size(), policy, true);
+    state = SliceLoopState{curTime, lastTime, numDone, overhead, arrived, decisions};
+    return lastTime;
+}
+
+//Slice granular simulation loop. Each scheduler decision covers a whole slice, which is applied
+//at once, so the cost is per decision rather than per time step. Non-preemptive schedulers make
+//one decision per CPU burst. Slices end at the next wakeup, so wakeups are admitted on time.
+//Switch costs are modeled as in simulate(). Produces the same schedule as simulate() and returns
+//the last simulated time. Publishes its progress to metrics and records the schedule in timeline
+//if given; the timeline is the same as simulate() records.
+template<class Policy>
+int simulateSlices(Policy& policy, vector<Process>& procList, SwitchModel& switches, MetricsPublisher* metrics = nullptr,
+                   ScheduleTimeline* timeline = nullptr)
+{
+    for(auto& p: procList)
+        resetBursts(p);
+    SliceLoopState state;
+    TimerWheel blocked;   //processes waiting for IO
+    return continueSlices(policy, procList, arrivalOrder(procList), state, blocked, switches, metrics, timeline);
+}
+
+//simulateSlices() with context switches for free
+template<class Policy>
+int simulateSlices(Policy& policy, vector<Process>& procList)
+{
+    SwitchModel free;
+    return simulateSlices(policy, procList, free);
+}
+
+//Quanta that get their own compiled specialization of the quantum based schedulers
+typedef integer_sequence<int, 1, 2, 3, 4, 5, 8, 10> ConstQuanta;
+
+//Builds Sched<Q> for the Q in Qs equal to timeQuantum and hands it to f.
+//Returns false if timeQuantum has no constant specialization.
+template<template<int> class Sched, class F, int... Qs, class... Args>
+bool withConstQuantum(integer_sequence<int, Qs...>, F& f, int timeQuantum, const Args&... args)
+{
+    auto run = [&](auto tag)
+    {
+        Sched<decltype(tag)::value> sched(timeQuantum, args...);
+        f(sched);
+        return true;
+    };
+    return ((timeQuantum == Qs && run(integral_constant<int, Qs>())) || ...);
+}
+
+//Constructs the scheduler selected by schedChoice (1-11, see the main menu) and calls f(scheduler).
+//This is the only place the choice is switched on, so f is instantiated once per policy.
+//Returns false for an unknown choice.
+template<class F>
+bool withScheduler(int schedChoice, int timeQuantum, int highQuantum, int lowQuantum, F&& f)
+{
+    switch(schedChoice)
+    {
+        case 1:
+            if(!withConstQuantum<RoundRobinScheduler>(ConstQuanta(), f, timeQuantum))
+            {
+                RoundRobinScheduler<> sched(timeQuantum);
+                f(sched);
+            }
+            return true;
+        case 2:
+        {
+            ShortestProcessNextScheduler sched;
+            f(sched);
+            return true;
+        }
+        case 3:
+        {
+            ShortestRemainingTimeScheduler sched;
+            f(sched);
+            return true;
+        }
+        case 4:
+        {
+            HighestResponseRatioNextScheduler sched;
+            f(sched);
+            return true;
+        }
+        case 5:
+        {
+            ModifiedHRRNScheduler sched;
+            f(sched);
+            return true;
+        }
+        case 6:
+        {
+            FIFOScheduler sched;
+            f(sched);
+            return true;
+        }
+        case 7:
+            if(!withConstQuantum<MultilevelQueueScheduler>(ConstQuanta(), f, timeQuantum))
+            {
+                MultilevelQueueScheduler<> sched(timeQuantum);
+                f(sched);
+            }
+            return true;
+        case 8:
+            if(!withConstQuantum<MultilevelFeedbackQueueScheduler>(ConstQuanta(), f, timeQuantum, highQuantum, lowQuantum))
+            {
+                MultilevelFeedbackQueueScheduler<> sched(timeQuantum, highQuantum, lowQuantum);
+                f(sched);
+            }
+            return true;
+        case 9:
+        {
+            EarliestDeadlineFirstScheduler<true> sched;
+            f(sched);
+            return true;
+        }
+        case 10:
+        {
+            EarliestDeadlineFirstScheduler<false> sched;
+            f(sched);
+            return true;
+        }
+        case 11:
+        {
+            LeastLaxityFirstScheduler sched;
+            f(sched);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
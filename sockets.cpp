@@ -0,0 +1,130 @@
+#include<cstring>      // memcpy
+#include<unistd.h>     // close, unlink
+#include<netdb.h>      // getaddrinfo
+#include<sys/socket.h> // socket, bind, listen, connect
+#include<sys/un.h>     // sockaddr_un
+#include<sys/stat.h>   // lstat
+#include "sockets.h"
+
+//splits a TCP address into host and port, returning false for a Unix domain socket path
+static bool splitTcp(const string& address, string& host, string& port)
+{
+    size_t colon = address.rfind(':');
+    if(colon == string::npos || address.find('/') != string::npos)
+        return false;
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+    return true;
+}
+
+//Creates a socket for address and hands it to f(fd, addr, len) until f succeeds. A listener
+//(socketPath given) first removes what an earlier run left at a Unix domain socket's path, and
+//fails with error set if something other than a socket is there.
+//Returns the socket, or -1.
+template<class F>
+static int withAddress(const string& address, const char* defaultHost, bool passive, string* socketPath, string& error, F f)
+{
+    string host, port;
+    if(!splitTcp(address, host, port))
+    {
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if(address.empty() || address.size() >= sizeof(addr.sun_path))
+            return -1;
+        memcpy(addr.sun_path, address.data(), address.size());
+        struct stat existing;
+        if(socketPath && lstat(address.c_str(), &existing) == 0)
+        {
+            if(!S_ISSOCK(existing.st_mode))
+            {
+                error = "\"" + address + "\" exists and is not a socket";
+                return -1;
+            }
+            unlink(address.c_str());
+        }
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0)
+            return -1;
+        if(!f(fd, reinterpret_cast<sockaddr*>(&addr), static_cast<socklen_t>(sizeof(addr))))
+        {
+            close(fd);
+            return -1;
+        }
+        if(socketPath)
+            *socketPath = address;
+        return fd;
+    }
+
+    addrinfo hints = {}, *found;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    if(getaddrinfo(host.empty() ? defaultHost : host.c_str(), port.c_str(), &hints, &found) != 0)
+        return -1;
+    int fd = -1;
+    for(addrinfo* a = found; a && fd < 0; a = a->ai_next)
+    {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if(fd < 0)
+            continue;
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if(!f(fd, a->ai_addr, a->ai_addrlen))
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    return fd;
+}
+
+int listenOn(const string& address, const char* defaultHost, string& socketPath, string& error)
+{
+    socketPath.clear();
+    error.clear();
+    int fd = withAddress(address, defaultHost, true, &socketPath, error, [](int fd, sockaddr* addr, socklen_t len)
+    {
+        return bind(fd, addr, len) == 0 && listen(fd, 64) == 0;
+    });
+    if(fd < 0 && error.empty())
+        error = "unable to listen on \"" + address + "\"";
+    return fd;
+}
+
+int connectTo(const string& address)
+{
+    string error;
+    return withAddress(address, "localhost", false, nullptr, error, [](int fd, sockaddr* addr, socklen_t len)
+    {
+        return connect(fd, addr, len) == 0;
+    });
+}
+
+bool sendAll(int fd, const string& data)
+{
+    for(size_t sent = 0; sent < data.size();)
+    {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if(n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+bool readLine(int fd, string& buffer, string& line)
+{
+    size_t newline;
+    while((newline = buffer.find('\n')) == string::npos)
+    {
+        char chunk[4096];
+        ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+        if(got <= 0)
+            return false;
+        buffer.append(chunk, got);
+    }
+    line.assign(buffer, 0, newline);
+    buffer.erase(0, newline + 1);
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef SOCKETS_H
+#define SOCKETS_H
+
+#include<string>
+
+using namespace std;
+
+//Small helpers over POSIX stream sockets. An address is "<host>:<port>" or ":<port>" for TCP, or
+//a path (anything containing a '/' or no ':') for a Unix domain socket.
+
+//Listens on address; ":<port>" listens on defaultHost. A Unix domain socket replaces a stale socket
+//at its path, but never another kind of file, and the path is stored in socketPath so the caller
+//can unlink it when done. Returns the listening socket, or -1 with error set.
+int listenOn(const string& address, const char* defaultHost, string& socketPath, string& error);
+
+//Connects to address (":<port>" connects to localhost). Returns the socket, or -1.
+int connectTo(const string& address);
+
+//sends all of data, returning false if the connection is gone
+bool sendAll(int fd, const string& data);
+
+//Reads from fd into buffer and moves the first complete line (without its newline) into line.
+//Returns false once the connection is closed with no complete line left.
+bool readLine(int fd, string& buffer, string& line);
+
+#endif
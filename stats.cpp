@@ -0,0 +1,330 @@
+#include<algorithm> // nth_element, max_element, stable_sort
+#include<numeric>   // iota
+#include<climits>   // INT_MAX
+#include<cmath>     // sqrt, log
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#define STATS_AVX2 1
+#endif
+#include "stats.h"
+
+void ProcessColumns::load(const vector<Process>& procList)
+{
+    size_t n = procList.size();
+    start.resize(n);
+    finish.resize(n);
+    total.resize(n);
+    io.resize(n);
+    deadline.resize(n);
+    group.resize(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        const Process& p = procList[i];
+        start[i] = p.startTime;
+        finish[i] = p.timeFinished;
+        total[i] = p.totalTimeNeeded;
+        io[i] = ioTime(p);
+        deadline[i] = absoluteDeadline(p);
+        group[i] = processGroup(p);
+    }
+}
+
+double RunStats::turnaroundVariance() const
+{
+    if(count == 0)
+        return 0;
+    double mean = meanTurnaround();
+    return max(sumSquaredTurnaround / count - mean * mean, 0.0);
+}
+
+//adds processes [from, to) to stats one at a time
+static void addScalar(const ProcessColumns& c, size_t from, size_t to, RunStats& stats, uint8_t* buckets)
+{
+    for(size_t i = from; i < to; ++i)
+    {
+        int turnaround = c.finish[i] + 1 - c.start[i];
+        stats.sumTurnaround += turnaround;
+        stats.sumNormalizedTurnaround += static_cast<double>(turnaround) / c.total[i];
+        stats.sumCpuWait += turnaround - c.total[i] - c.io[i];
+        stats.sumIo += c.io[i];
+        stats.sumSquaredTurnaround += static_cast<double>(turnaround) * turnaround;
+        stats.minTurnaround = min(stats.minTurnaround, turnaround);
+        stats.maxTurnaround = max(stats.maxTurnaround, turnaround);
+        int b = histogramBucket(turnaround);
+        ++stats.histogram[b];
+        if(buckets)
+            buckets[i] = b;
+    }
+}
+
+#ifdef STATS_AVX2
+//sum of the 4 64 bit lanes
+__attribute__((target("avx2")))
+static long long sumLanes(__m256i v)
+{
+    long long lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("avx2")))
+static double sumLanes(__m256d v)
+{
+    double lanes[4];
+    _mm256_storeu_pd(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+//adds the 8 32 bit lanes of v, widened to 64 bits, to sum
+__attribute__((target("avx2")))
+static __m256i addWidened(__m256i sum, __m256i v)
+{
+    sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+//Adds processes [0, n & ~7) to stats 8 at a time and returns the number added. The histogram
+//bucket is found from the exponent of the turnaround time converted to float, corrected for
+//values that round up to the next power of two.
+__attribute__((target("avx2")))
+static size_t addAvx2(const ProcessColumns& c, RunStats& stats, uint8_t* buckets)
+{
+    size_t n = c.size() & ~static_cast<size_t>(7);
+    const __m256i one = _mm256_set1_epi32(1), three = _mm256_set1_epi32(3), eight = _mm256_set1_epi32(8);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sumTurnaround = zero, sumCpuWait = zero, sumIo = zero;
+    __m256i minTurnaround = _mm256_set1_epi32(INT_MAX), maxTurnaround = _mm256_set1_epi32(INT_MIN);
+    __m256d sumNormalized = _mm256_setzero_pd(), sumSquared = _mm256_setzero_pd();
+    alignas(32) int lanes[8];
+
+    for(size_t i = 0; i < n; i += 8)
+    {
+        __m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&c.start[i]));
+        __m256i finish = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&c.finish[i]));
+        __m256i total = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&c.total[i]));
+        __m256i io = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&c.io[i]));
+
+        __m256i turnaround = _mm256_sub_epi32(_mm256_add_epi32(finish, one), start);
+        __m256i cpuWait = _mm256_sub_epi32(_mm256_sub_epi32(turnaround, total), io);
+        sumTurnaround = addWidened(sumTurnaround, turnaround);
+        sumCpuWait = addWidened(sumCpuWait, cpuWait);
+        sumIo = addWidened(sumIo, io);
+        minTurnaround = _mm256_min_epi32(minTurnaround, turnaround);
+        maxTurnaround = _mm256_max_epi32(maxTurnaround, turnaround);
+
+        for(int half = 0; half < 2; ++half)
+        {
+            __m128i t = half ? _mm256_extracti128_si256(turnaround, 1) : _mm256_castsi256_si128(turnaround);
+            __m128i s = half ? _mm256_extracti128_si256(total, 1) : _mm256_castsi256_si128(total);
+            __m256d td = _mm256_cvtepi32_pd(t);
+            sumNormalized = _mm256_add_pd(sumNormalized, _mm256_div_pd(td, _mm256_cvtepi32_pd(s)));
+            sumSquared = _mm256_add_pd(sumSquared, _mm256_mul_pd(td, td));
+        }
+
+        //bucket = value below 8, else 8 + (e - 3) * 4 + ((value >> (e - 2)) & 3), e = floor(log2(value))
+        __m256i clamped = _mm256_max_epi32(turnaround, zero);
+        __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(clamped)), 23), _mm256_set1_epi32(127));
+        __m256i roundedUp = _mm256_cmpeq_epi32(_mm256_srlv_epi32(clamped, e), zero);
+        e = _mm256_add_epi32(e, roundedUp);
+        __m256i sub = _mm256_and_si256(_mm256_srlv_epi32(clamped, _mm256_sub_epi32(e, _mm256_set1_epi32(2))), three);
+        __m256i logBucket = _mm256_add_epi32(_mm256_add_epi32(eight, _mm256_slli_epi32(_mm256_sub_epi32(e, three), 2)), sub);
+        __m256i small = _mm256_cmpgt_epi32(eight, clamped);
+        __m256i bucket = _mm256_blendv_epi8(logBucket, clamped, small);
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), bucket);
+        for(int k = 0; k < 8; ++k)
+            ++stats.histogram[lanes[k]];
+        if(buckets)
+            for(int k = 0; k < 8; ++k)
+                buckets[i + k] = lanes[k];
+    }
+
+    stats.sumTurnaround += sumLanes(sumTurnaround);
+    stats.sumCpuWait += sumLanes(sumCpuWait);
+    stats.sumIo += sumLanes(sumIo);
+    stats.sumNormalizedTurnaround += sumLanes(sumNormalized);
+    stats.sumSquaredTurnaround += sumLanes(sumSquared);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), minTurnaround);
+    for(int k = 0; k < 8 && n > 0; ++k)
+        stats.minTurnaround = min(stats.minTurnaround, lanes[k]);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), maxTurnaround);
+    for(int k = 0; k < 8 && n > 0; ++k)
+        stats.maxTurnaround = max(stats.maxTurnaround, lanes[k]);
+    return n;
+}
+#endif
+
+void computeRunStats(const ProcessColumns& columns, RunStats& stats, vector<uint8_t>* buckets)
+{
+    stats = RunStats();
+    stats.count = columns.size();
+    stats.minTurnaround = INT_MAX;
+    stats.maxTurnaround = INT_MIN;
+    if(buckets)
+        buckets->resize(columns.size());
+    uint8_t* bucketOut = buckets ? buckets->data() : nullptr;
+
+    size_t done = 0;
+#ifdef STATS_AVX2
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if(hasAvx2)
+        done = addAvx2(columns, stats, bucketOut);
+#endif
+    addScalar(columns, done, columns.size(), stats, bucketOut);
+    if(stats.count == 0)
+        stats.minTurnaround = stats.maxTurnaround = 0;
+}
+
+int turnaroundPercentile(const ProcessColumns& columns, const RunStats& stats, const vector<uint8_t>& buckets, int pct)
+{
+    if(stats.count == 0)
+        return 0;
+    long long rank = max((stats.count * pct + 99) / 100, 1LL), seen = 0;
+    int b = 0;
+    while(seen + stats.histogram[b] < rank)
+        seen += stats.histogram[b++];
+
+    vector<int> inBucket;
+    inBucket.reserve(stats.histogram[b]);
+    for(size_t i = 0; i < columns.size(); ++i)
+        if(buckets[i] == b)
+            inBucket.push_back(columns.finish[i] + 1 - columns.start[i]);
+    auto nth = inBucket.begin() + (rank - seen - 1);
+    nth_element(inBucket.begin(), nth, inBucket.end());
+    return *nth;
+}
+
+void computeDeadlineStats(const ProcessColumns& columns, DeadlineStats& stats)
+{
+    stats = DeadlineStats();
+    vector<int> tardiness;
+    long long sum = 0;
+    for(size_t i = 0; i < columns.size(); ++i)
+        if(columns.deadline[i] != INT_MAX)
+        {
+            int late = max(static_cast<int>(min(columns.finish[i] + 1LL - columns.deadline[i], static_cast<long long>(INT_MAX))), 0);
+            tardiness.push_back(late);
+            sum += late;
+            stats.missed += late > 0;
+        }
+    stats.count = tardiness.size();
+    if(tardiness.empty())
+        return;
+    stats.meanTardiness = static_cast<double>(sum) / stats.count;
+    auto rank = [&](int pct) { return tardiness.begin() + (max((stats.count * pct + 99) / 100, 1LL) - 1); };
+    //the ranks are taken in increasing order, so each selection only looks above the one before
+    nth_element(tardiness.begin(), rank(90), tardiness.end());
+    stats.tardiness90 = *rank(90);
+    nth_element(rank(90), rank(99), tardiness.end());
+    stats.tardiness99 = *rank(99);
+    stats.maxTardiness = *max_element(rank(99), tardiness.end());
+}
+
+void computeGroupStats(const ProcessColumns& columns, vector<GroupStats>& groups)
+{
+    groups.clear();
+    //the processes by group, in list order within each
+    vector<size_t> order(columns.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return columns.group[a] < columns.group[b]; });
+    vector<int> turnaround;
+    for(size_t begin = 0, end; begin < order.size(); begin = end)
+    {
+        GroupStats g = GroupStats();
+        g.group = columns.group[order[begin]];
+        g.firstStart = INT_MAX;
+        g.lastFinish = INT_MIN;
+        turnaround.clear();
+        double sumNormalized = 0;
+        long long sumTurnaround = 0, sumWait = 0;
+        for(end = begin; end < order.size() && columns.group[order[end]] == g.group; ++end)
+        {
+            size_t i = order[end];
+            int t = columns.finish[i] + 1 - columns.start[i];
+            turnaround.push_back(t);
+            sumTurnaround += t;
+            sumNormalized += static_cast<double>(t) / columns.total[i];
+            sumWait += t - columns.total[i] - columns.io[i];
+            g.cpuTime += columns.total[i];
+            g.firstStart = min(g.firstStart, columns.start[i]);
+            g.lastFinish = max(g.lastFinish, columns.finish[i]);
+        }
+        g.count = turnaround.size();
+        g.meanTurnaround = static_cast<double>(sumTurnaround) / g.count;
+        g.meanNormalizedTurnaround = sumNormalized / g.count;
+        g.meanCpuWait = static_cast<double>(sumWait) / g.count;
+        auto rank = turnaround.begin() + (max((g.count * 99 + 99) / 100, 1LL) - 1);
+        nth_element(turnaround.begin(), rank, turnaround.end());
+        g.turnaround99 = *rank;
+        g.maxTurnaround = *max_element(rank, turnaround.end());
+        groups.push_back(g);
+    }
+}
+
+//Inverse of the standard normal distribution function (Acklam's rational approximation, relative
+//error below 1.2e-9)
+static double normalQuantile(double p)
+{
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+    if(p < 0.02425 || p > 1 - 0.02425)
+    {
+        double q = sqrt(-2 * log(p < 0.5 ? p : 1 - p));
+        double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+        return p < 0.5 ? x : -x;
+    }
+    double q = p - 0.5, r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+           / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+//Probability that |T| < t for Student's t with df degrees of freedom (the finite series for an
+//integer df, Abramowitz and Stegun 26.7.3 and 26.7.4)
+static double studentCoverage(double t, long long df)
+{
+    double theta = atan(t / sqrt(static_cast<double>(df))), c2 = cos(theta) * cos(theta);
+    double term = 1, sum = 1;
+    for(long long k = df % 2 ? 3 : 2; k < df; k += 2)
+    {
+        term *= c2 * (k - 1) / k;
+        sum += term;
+    }
+    if(df % 2)
+        return 2 / M_PI * (theta + (df > 1 ? sin(theta) * cos(theta) * sum : 0));
+    return sin(theta) * sum;
+}
+
+double studentT(double confidence, long long df)
+{
+    double p = (1 + confidence) / 2;
+    df = max(df, 1LL);
+    if(df >= 30)
+    {
+        //Cornish-Fisher expansion about the normal quantile
+        double z = normalQuantile(p), z2 = z * z, v = static_cast<double>(df);
+        return z + z * (z2 + 1) / (4 * v) + z * ((5 * z2 + 16) * z2 + 3) / (96 * v * v)
+                 + z * (((3 * z2 + 19) * z2 + 17) * z2 - 15) / (384 * v * v * v);
+    }
+    //bisection on the coverage, which rises with t
+    double lo = 0, hi = 1;
+    while(studentCoverage(hi, df) < confidence)
+        hi *= 2;
+    for(int i = 0; i < 60; ++i)
+    {
+        double mid = (lo + hi) / 2;
+        (studentCoverage(mid, df) < confidence ? lo : hi) = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+double RunningStats::halfWidth(double confidence) const
+{
+    if(count < 2)
+        return 0;
+    return studentT(confidence, count - 1) * sqrt(variance() / count);
+}
@@ -0,0 +1,140 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include<vector>
+#include<cstdint>
+#include "schedulers.h"
+
+using namespace std;
+
+//Turnaround histograms use log-linear buckets: values below 8 get their own bucket, above that
+//there are four buckets per power of two, so a bucket is at most 25% wide
+const int HISTOGRAM_BUCKETS = 8 + 28 * 4;
+
+//bucket of a turnaround time (negative times go in bucket 0)
+inline int histogramBucket(int value)
+{
+    if(value < 8)
+        return value < 0 ? 0 : value;
+    int e = 31 - __builtin_clz(value);
+    return 8 + (e - 3) * 4 + ((value >> (e - 2)) & 3);
+}
+
+//largest value in bucket b
+inline long long histogramBucketTop(int b)
+{
+    if(b < 8)
+        return b;
+    int e = (b - 8) / 4 + 3;
+    return ((4LL + (b - 8) % 4 + 1) << (e - 2)) - 1;
+}
+
+//The per process data the run statistics are computed from, one array per field so the
+//statistics kernels can stream through them
+struct ProcessColumns
+{
+    vector<int> start;    //start time
+    vector<int> finish;   //time the process completed
+    vector<int> total;    //total CPU time needed
+    vector<int> io;       //time spent blocked on IO
+    vector<int> deadline; //time the process should have completed by, INT_MAX for none
+    vector<int> group;    //group (tenant), 0 for the default one
+
+    void load(const vector<Process>& procList);
+    size_t size() const { return start.size(); }
+};
+
+//Aggregates of a run, over every process. The turnaround time is finish + 1 - start, the
+//normalized turnaround is that over the CPU time needed and the CPU wait time is the turnaround
+//less the CPU and IO time.
+struct RunStats
+{
+    long long count;
+    long long sumTurnaround;
+    double sumNormalizedTurnaround;
+    long long sumCpuWait;
+    long long sumIo;
+    double sumSquaredTurnaround;
+    int minTurnaround;
+    int maxTurnaround;
+    long long histogram[HISTOGRAM_BUCKETS];    //turnaround times
+
+    double meanTurnaround() const { return count ? static_cast<double>(sumTurnaround) / count : 0; }
+    double meanNormalizedTurnaround() const { return count ? sumNormalizedTurnaround / count : 0; }
+    double meanCpuWait() const { return count ? static_cast<double>(sumCpuWait) / count : 0; }
+    double meanIo() const { return count ? static_cast<double>(sumIo) / count : 0; }
+    double turnaroundVariance() const;
+};
+
+//Computes the run statistics in one pass over the columns, using AVX2 where the processor has it.
+//If buckets is given it receives the histogram bucket of each process's turnaround time.
+void computeRunStats(const ProcessColumns& columns, RunStats& stats, vector<uint8_t>* buckets = nullptr);
+
+//Exact turnaround time at percentile pct (nearest rank). The histogram finds the bucket holding
+//the rank, so only the turnaround times in that bucket are selected from.
+int turnaroundPercentile(const ProcessColumns& columns, const RunStats& stats, const vector<uint8_t>& buckets, int pct);
+
+//How the processes with deadlines fared. A process misses its deadline if it completes (at its
+//finish time + 1, as for the turnaround) after it; its tardiness is how much later, 0 if it made it.
+struct DeadlineStats
+{
+    long long count;        //processes with a deadline
+    long long missed;
+    double meanTardiness;   //over the processes with a deadline
+    int tardiness90;        //tardiness tails (nearest rank)
+    int tardiness99;
+    int maxTardiness;
+    double missRatio() const { return count ? static_cast<double>(missed) / count : 0; }
+};
+
+//Computes the deadline statistics, all 0 if no process has a deadline
+void computeDeadlineStats(const ProcessColumns& columns, DeadlineStats& stats);
+
+//How the processes of one group (tenant) fared
+struct GroupStats
+{
+    int group;
+    long long count;
+    long long cpuTime;          //CPU time its processes needed
+    int firstStart;             //its first arrival and last completion
+    int lastFinish;
+    double meanTurnaround;
+    double meanNormalizedTurnaround;
+    double meanCpuWait;
+    int turnaround99;           //nearest rank
+    int maxTurnaround;
+    //processes completed per time step, between its first arrival and its last completion
+    double throughput() const { return count ? count / static_cast<double>(lastFinish + 1 - firstStart) : 0; }
+};
+
+//Computes the statistics of each group that has processes, in group order
+void computeGroupStats(const ProcessColumns& columns, vector<GroupStats>& groups);
+
+//Running mean and variance of a series of values, updated one value at a time (Welford's method,
+//which doesn't lose precision to cancellation the way summing squares does)
+struct RunningStats
+{
+    RunningStats() : count(0), mean(0), m2(0) {}
+
+    long long count;
+    double mean;
+    double m2;      //sum of squared differences from the mean
+
+    void add(double x)
+    {
+        ++count;
+        double d = x - mean;
+        mean += d / count;
+        m2 += d * (x - mean);
+    }
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0; }
+    //half the width of the confidence interval of the mean at the given level (Student's t)
+    double halfWidth(double confidence) const;
+};
+
+//Two sided critical value of Student's t distribution with df degrees of freedom at the given
+//confidence level: found by bisection on the distribution below 30 degrees of freedom, from a
+//series about the normal quantile above, either way to well within 0.1%.
+double studentT(double confidence, long long df);
+
+#endif
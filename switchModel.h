@@ -0,0 +1,44 @@
+#ifndef SWITCHMODEL_H
+#define SWITCHMODEL_H
+
+#include "schedulers.h"
+
+//Context switch cost model. Dispatching a process other than the one that ran last costs
+//fixed + perWorkingSet * workingSet time steps, during which no process makes progress.
+//Costs may be fractions of a time step; they add up and the simulation is delayed by whole
+//steps as the total crosses them. The model also counts the switches for the run statistics.
+class SwitchModel
+{
+public:
+    explicit SwitchModel(double fixed = 0, double perWorkingSet = 0)
+        : fixed(fixed), perWorkingSet(perWorkingSet), last(-1), switches(0), overhead(0), charged(0) {}
+
+    //process idx is about to run; returns the whole time steps the switch to it adds
+    int dispatch(int idx, const Process& p)
+    {
+        if(idx == last)
+            return 0;
+        last = idx;
+        ++switches;
+        overhead += fixed + perWorkingSet * workingSet(p);
+        int steps = static_cast<int>(overhead) - charged;
+        charged += steps;
+        return steps;
+    }
+
+    //number of switches so far
+    long long count() const { return switches; }
+
+    //time spent switching so far, in (fractional) time steps
+    double totalOverhead() const { return overhead; }
+
+private:
+    double fixed;           //cost of every switch
+    double perWorkingSet;   //cost per unit of the incoming process's working set
+    int last;               //process that ran last, -1 before the first dispatch
+    long long switches;     //number of switches
+    double overhead;        //total cost of the switches
+    int charged;            //whole time steps of overhead the simulation was delayed by
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include<cstdio>  // snprintf
+#include "timeline.h"
+
+const ScheduleInterval* ScheduleTimeline::at(int time, int core) const
+{
+    if(core >= cores())
+        return nullptr;
+    const Lane& lane = lanes[core];
+    //first interval starting after time; the one before it is the only one that can cover time
+    size_t low = 0, high = lane.count;
+    while(low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if(lane[mid].start <= time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if(low == 0 || lane[low - 1].end <= time)
+        return nullptr;
+    return &lane[low - 1];
+}
+
+//writes s as a JSON string
+static void writeJsonString(ostream& out, string_view s)
+{
+    out << '"';
+    for(char c: s)
+    {
+        if(c == '"' || c == '\\')
+            out << '\\' << c;
+        else if(static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        }
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+static const char* reasonName(RunReason reason)
+{
+    switch(reason)
+    {
+        case RunReason::SWITCH:
+            return "switch";
+        case RunReason::PREEMPTED:
+            return "preempted";
+        case RunReason::BLOCKED:
+            return "blocked";
+        case RunReason::COMPLETED:
+            return "completed";
+    }
+    return "";
+}
+
+void writeChromeTrace(ostream& out, const ScheduleTimeline& timeline, const vector<Process>& procList)
+{
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&]()
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    for(int core = 0; core < timeline.cores(); ++core)
+    {
+        separate();
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << core << ",\"args\":{\"name\":\"CPU " << core << "\"}}";
+        //a process's track is named the first time it runs on the core
+        vector<bool> named(procList.size(), false);
+        for(size_t i = 0; i < timeline.size(core); ++i)
+        {
+            const ScheduleInterval& run = timeline.interval(i, core);
+            if(!named[run.process])
+            {
+                named[run.process] = true;
+                separate();
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << core << ",\"tid\":" << run.process << ",\"args\":{\"name\":";
+                writeJsonString(out, processName(procList[run.process]));
+                out << "}}";
+            }
+            separate();
+            out << "{\"name\":";
+            if(run.reason == RunReason::SWITCH)
+                out << "\"switch\"";
+            else
+                writeJsonString(out, processName(procList[run.process]));
+            out << ",\"cat\":\"" << (run.reason == RunReason::SWITCH ? "switch" : "run") << "\",\"ph\":\"X\",\"pid\":" << core
+                << ",\"tid\":" << run.process << ",\"ts\":" << run.start << ",\"dur\":" << run.end - run.start
+                << ",\"args\":{\"reason\":\"" << reasonName(run.reason) << "\"}}";
+        }
+    }
+    out << "\n]}\n";
+}
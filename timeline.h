@@ -0,0 +1,96 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include<vector>
+#include<memory>  // unique_ptr
+#include<cstdint>
+#include<ostream>
+#include "schedulers.h"
+
+using namespace std;
+
+//why an interval of the schedule ended
+enum class RunReason : uint8_t
+{
+    SWITCH,     //context switch to the process, nothing ran
+    PREEMPTED,  //the process was descheduled while still runnable
+    BLOCKED,    //the process's CPU burst ended and it blocked on IO
+    COMPLETED   //the process finished
+};
+
+//One run of a process on a core: time steps [start, end)
+struct ScheduleInterval
+{
+    int start;
+    int end;
+    int process;        //index into the process list
+    uint16_t core;
+    RunReason reason;
+};
+static_assert(sizeof(ScheduleInterval) == 16, "schedule intervals are meant to stay compact");
+
+//The schedule of a simulation as run-length intervals rather than per time step rows, so a
+//schedule of millions of time steps costs one interval per dispatch. Intervals are kept per core
+//in blocks of BLOCK_SIZE that are never moved, so recording never copies the earlier schedule.
+//Time steps in which a core ran nothing (idle) have no interval.
+class ScheduleTimeline
+{
+public:
+    static const size_t BLOCK_SIZE = 1 << 12;
+
+    //Records that process ran on core for length time steps from start. Runs must be recorded in
+    //time order per core. A run continuing the previous interval of the same process extends it.
+    void record(int process, int start, int length, RunReason reason, int core = 0)
+    {
+        if(core >= static_cast<int>(lanes.size()))
+            lanes.resize(core + 1);
+        Lane& lane = lanes[core];
+        if(lane.count > 0)
+        {
+            ScheduleInterval& last = lane[lane.count - 1];
+            bool continues = last.process == process && last.end == start
+                             && (last.reason == RunReason::PREEMPTED ? reason != RunReason::SWITCH : last.reason == reason);
+            if(continues)
+            {
+                last.end = start + length;
+                last.reason = reason;
+                return;
+            }
+        }
+        if(lane.count == lane.blocks.size() * BLOCK_SIZE)
+            lane.blocks.emplace_back(new ScheduleInterval[BLOCK_SIZE]);
+        lane[lane.count++] = ScheduleInterval{start, start + length, process, static_cast<uint16_t>(core), reason};
+    }
+
+    //number of cores that ran something
+    int cores() const { return lanes.size(); }
+
+    //number of intervals recorded for core
+    size_t size(int core = 0) const { return core < cores() ? lanes[core].count : 0; }
+
+    //the i-th interval of core, in time order
+    const ScheduleInterval& interval(size_t i, int core = 0) const { return lanes[core][i]; }
+
+    //The interval of core covering time, or nullptr if the core was idle. A binary search, so
+    //O(log n) in the number of intervals.
+    const ScheduleInterval* at(int time, int core = 0) const;
+
+private:
+    struct Lane
+    {
+        vector<unique_ptr<ScheduleInterval[]>> blocks;
+        size_t count = 0;
+
+        ScheduleInterval& operator[](size_t i) { return blocks[i / BLOCK_SIZE][i % BLOCK_SIZE]; }
+        const ScheduleInterval& operator[](size_t i) const { return blocks[i / BLOCK_SIZE][i % BLOCK_SIZE]; }
+    };
+
+    vector<Lane> lanes;   //intervals of each core
+};
+
+//Writes the timeline as Chrome trace event JSON, which chrome://tracing and Perfetto load: one
+//track per process under one trace process per core, one time step to a microsecond. Events are
+//written as they are read from the timeline, nothing is built up in memory.
+void writeChromeTrace(ostream& out, const ScheduleTimeline& timeline, const vector<Process>& procList);
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include<vector>
+#include<cstdint>
+#include<climits>
+#include<cstring> // memcpy
+#include<utility> // pair
+
+using namespace std;
+
+//Hierarchical timing wheel holding the processes blocked on IO, keyed by the time they wake up.
+//Level k has 64 slots, each covering 64^k time steps, so six levels cover any int time.
+//An entry sits at the level of the highest 6 bit group in which its wakeup time differs from the
+//wheel's current time; when time reaches the block an entry's slot covers, the slot is cascaded
+//into the lower levels. Entries are intrusive doubly linked lists indexed by process index, so
+//insert and remove are O(1); the links take 16 bytes for every index up to the largest inserted,
+//whether or not that process is sleeping.
+class TimerWheel
+{
+public:
+    static const int LEVELS = 6;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    TimerWheel() : now(0), count(0)
+    {
+        for(int k = 0; k < LEVELS; ++k)
+        {
+            occupied[k] = 0;
+            for(int s = 0; s < SLOTS; ++s)
+                head[k][s] = tail[k][s] = -1;
+        }
+    }
+
+    //number of processes in the wheel
+    int size() const { return count; }
+
+    //makes room for the processes 0 to ids - 1, so inserting them doesn't allocate
+    void reserve(int ids) { nodes.reserve(ids); }
+
+    //adds process id, waking it at time expiry (>= the current time)
+    void insert(int id, int expiry)
+    {
+        if(id >= static_cast<int>(nodes.size()))
+            nodes.resize(id + 1);
+        nodes[id].expiry = expiry < now ? now : expiry;
+        link(id);
+        ++count;
+    }
+
+    //removes process id before it wakes up
+    void remove(int id)
+    {
+        unlink(id);
+        --count;
+    }
+
+    //Lower bound on the next wakeup time, exact when the next wakeup is within 64 steps.
+    //INT_MAX if the wheel is empty.
+    int nextExpiry() const
+    {
+        if(count == 0)
+            return INT_MAX;
+        for(int k = 0; k < LEVELS; ++k)
+        {
+            int shift = k * SLOT_BITS;
+            int group = (now >> shift) & (SLOTS - 1);
+            //level 0 holds entries in the current block, higher levels only later blocks
+            uint64_t later = k == 0 ? occupied[k] >> group << group : (group == SLOTS - 1 ? 0 : occupied[k] >> (group + 1) << (group + 1));
+            if(later)
+            {
+                int slot = __builtin_ctzll(later);
+                long long parent = static_cast<long long>(now) >> (shift + SLOT_BITS) << (shift + SLOT_BITS);
+                return static_cast<int>(parent + (static_cast<long long>(slot) << shift));
+            }
+        }
+        return INT_MAX;
+    }
+
+    //A copy of the wheel holding only the links of the processes in it, where copying the wheel
+    //would copy a link for every process that was ever blocked
+    struct Saved;
+    void save(Saved& saved) const;
+    void restore(const Saved& saved);
+
+    //removes every process waking at or before time, calling wake(id, expiry) in wakeup order
+    template<class F>
+    void expire(int time, F wake)
+    {
+        int next;
+        while((next = nextExpiry()) <= time)
+        {
+            advance(next);
+            int slot = next & (SLOTS - 1);
+            while(head[0][slot] >= 0)
+            {
+                int id = head[0][slot];
+                unlink(id);
+                --count;
+                wake(id, nodes[id].expiry);
+            }
+        }
+        if(time > now)
+            advance(time);
+    }
+
+private:
+    struct Node
+    {
+        int expiry;   //wakeup time
+        int next;     //next process in the slot, -1 at the end
+        int prev;     //previous process in the slot, -1 at the start
+        int8_t level; //wheel level of the slot
+        uint8_t slot; //slot within the level
+    };
+
+    static int levelFor(int expiry, int now)
+    {
+        unsigned int diff = static_cast<unsigned int>(expiry ^ now);
+        if(diff == 0)
+            return 0;
+        return (31 - __builtin_clz(diff)) / SLOT_BITS;
+    }
+
+    void link(int id)
+    {
+        Node& n = nodes[id];
+        int k = levelFor(n.expiry, now);
+        int s = (n.expiry >> (k * SLOT_BITS)) & (SLOTS - 1);
+        n.level = k;
+        n.slot = s;
+        n.next = -1;
+        n.prev = tail[k][s];
+        if(tail[k][s] >= 0)
+            nodes[tail[k][s]].next = id;
+        else
+            head[k][s] = id;
+        tail[k][s] = id;
+        occupied[k] |= 1ULL << s;
+    }
+
+    void unlink(int id)
+    {
+        Node& n = nodes[id];
+        if(n.prev >= 0)
+            nodes[n.prev].next = n.next;
+        else
+            head[n.level][n.slot] = n.next;
+        if(n.next >= 0)
+            nodes[n.next].prev = n.prev;
+        else
+            tail[n.level][n.slot] = n.prev;
+        if(head[n.level][n.slot] < 0)
+            occupied[n.level] &= ~(1ULL << n.slot);
+    }
+
+    //moves the current time to time, which no entry wakes before, cascading the slots of the
+    //blocks that time enters into the lower levels
+    void advance(int time)
+    {
+        int top = levelFor(time, now);
+        now = time;
+        for(int k = top; k > 0; --k)
+        {
+            int s = (time >> (k * SLOT_BITS)) & (SLOTS - 1);
+            int id = head[k][s];
+            head[k][s] = tail[k][s] = -1;
+            occupied[k] &= ~(1ULL << s);
+            while(id >= 0)
+            {
+                int next = nodes[id].next;
+                link(id);
+                id = next;
+            }
+        }
+    }
+
+    int now;                        //current time of the wheel
+    int count;                      //number of processes in the wheel
+    int head[LEVELS][SLOTS];        //first process in each slot, -1 if empty
+    int tail[LEVELS][SLOTS];        //last process in each slot, -1 if empty
+    uint64_t occupied[LEVELS];      //bit per non-empty slot
+    vector<Node> nodes;             //wheel links, indexed by process
+};
+
+struct TimerWheel::Saved
+{
+    int now;
+    int count;
+    int head[LEVELS][SLOTS];
+    int tail[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS];
+    vector<pair<int, Node>> entries;    //process and its links
+};
+
+inline void TimerWheel::save(Saved& saved) const
+{
+    saved.now = now;
+    saved.count = count;
+    memcpy(saved.head, head, sizeof(head));
+    memcpy(saved.tail, tail, sizeof(tail));
+    memcpy(saved.occupied, occupied, sizeof(occupied));
+    saved.entries.clear();
+    for(int k = 0; k < LEVELS; ++k)
+        for(int s = 0; s < SLOTS; ++s)
+            for(int id = head[k][s]; id >= 0; id = nodes[id].next)
+                saved.entries.emplace_back(id, nodes[id]);
+}
+
+inline void TimerWheel::restore(const Saved& saved)
+{
+    now = saved.now;
+    count = saved.count;
+    memcpy(head, saved.head, sizeof(head));
+    memcpy(tail, saved.tail, sizeof(tail));
+    memcpy(occupied, saved.occupied, sizeof(occupied));
+    for(auto& entry: saved.entries)
+    {
+        if(entry.first >= static_cast<int>(nodes.size()))
+            nodes.resize(entry.first + 1);
+        nodes[entry.first] = entry.second;
+    }
+}
+
+#endif
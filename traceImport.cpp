@@ -0,0 +1,307 @@
+#include<cstring>       // strncmp
+#include<unordered_map> // per task records
+#include "traceImport.h"
+
+//size of the read buffer used for trace files
+static const size_t READ_BUFFER_SIZE = 1 << 20;
+
+//name given to tasks that are only known by their pid
+static const string PID_NAME = "pid";
+
+//What the importers remember about a task while streaming the dump
+struct TaskRecord
+{
+    int idx;            //index of the task's process in procList
+    long long first;    //time the task was first seen (ns)
+    long long lastIn;   //time the task was last switched in (ns), -1 while not running
+    long long cpuNs;    //on-CPU time accumulated so far (ns)
+    long long firstRun; //schedstat run time at the first snapshot (ns)
+    long long lastRun;  //schedstat run time at the latest snapshot (ns)
+    int snapshots;      //number of schedstat snapshots the task appeared in
+};
+
+static bool openTrace(const string& fname, ifstream& in, vector<char>& buffer)
+{
+    buffer.resize(READ_BUFFER_SIZE);
+    in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    in.open(fname.c_str());
+    return !in.fail();
+}
+
+//parses a non-negative integer at p, advancing p past it
+static long long parseInt(const char*& p)
+{
+    long long value = 0;
+    while(*p >= '0' && *p <= '9')
+        value = value * 10 + (*p++ - '0');
+    return value;
+}
+
+//parses a "seconds.fraction" timestamp at p as nanoseconds
+static long long parseTimestampNs(const char* p)
+{
+    long long ns = parseInt(p) * 1000000000LL;
+    if(*p == '.')
+    {
+        long long scale = 100000000LL;
+        for(++p; *p >= '0' && *p <= '9'; ++p, scale /= 10)
+            ns += (*p - '0') * scale;
+    }
+    return ns;
+}
+
+//finds " key=" in line at or after from and returns the position of its value, or npos
+static size_t findField(const string& line, size_t from, const char* key)
+{
+    size_t pos = line.find(key, from);
+    return pos == string::npos ? pos : pos + strlen(key);
+}
+
+//nice value derived priority: 0-4 for negative nice (and real time tasks), 5-9 otherwise
+static int priorityFromPrio(int prio)
+{
+    if(prio < 100)
+        return 0;
+    int priority = (prio - 120 + 20) / 4;
+    return priority < 0 ? 0 : (priority > 9 ? 9 : priority);
+}
+
+//ceiling of ns in simulated time units, at least one unit
+static int toTicks(long long ns, long long tickNs)
+{
+    long long ticks = (ns + tickNs - 1) / tickNs;
+    return ticks < 1 ? 1 : static_cast<int>(ticks);
+}
+
+//returns the record for pid, creating its process on first sight
+static TaskRecord& lookupTask(unordered_map<int, TaskRecord>& tasks, vector<Process>& procList, string& name,
+                              int pid, const string& line, size_t commBegin, size_t commEnd, long long now)
+{
+    auto found = tasks.find(pid);
+    if(found != tasks.end())
+        return found->second;
+
+    //the id is "comm-pid", built in the caller's buffer and interned
+    name.assign(line, commBegin, commEnd - commBegin).append("-").append(to_string(pid));
+    Process p;
+    setProcessName(p, name);
+    p.startTime = 0;
+    p.totalTimeNeeded = 0;
+    p.priority = priorityFromPrio(120);
+    procList.push_back(p);
+
+    TaskRecord& rec = tasks[pid];
+    rec = {static_cast<int>(procList.size()) - 1, now, -1, 0, 0, 0, 0};
+    return rec;
+}
+
+bool importSchedTrace(const string& fname, vector<Process>& procList, long long tickNs)
+{
+    ifstream in;
+    vector<char> buffer;
+    if(!openTrace(fname, in, buffer))
+        return false;
+
+    unordered_map<int, TaskRecord> tasks;
+    string line, name;
+    long long firstTs = -1, lastTs = 0;
+    procList.clear();
+    tasks.reserve(1 << 16);
+
+    while(getline(in, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+
+        //find the event name; the timestamp is the token ending in ':' right before it
+        size_t event = line.find("sched_");
+        while(event != string::npos && line.compare(event, 13, "sched_switch:") != 0
+              && line.compare(event, 13, "sched_wakeup:") != 0 && line.compare(event, 17, "sched_wakeup_new:") != 0)
+            event = line.find("sched_", event + 6);
+        if(event == string::npos)
+            continue;
+        size_t tsEnd = line.rfind(':', event - (event >= 6 && line.compare(event - 6, 6, "sched:") == 0 ? 7 : 1));
+        if(tsEnd == string::npos)
+            continue;
+        size_t tsBegin = line.rfind(' ', tsEnd);
+        tsBegin = (tsBegin == string::npos) ? 0 : tsBegin + 1;
+        long long now = parseTimestampNs(line.c_str() + tsBegin);
+        if(firstTs < 0)
+            firstTs = now;
+        lastTs = now;
+
+        if(line[event + 6] == 's')
+        {
+            //sched_switch: prev_comm=A prev_pid=1 prev_prio=120 prev_state=S ==> next_comm=B next_pid=2 next_prio=120
+            size_t prevComm = findField(line, event, " prev_comm=");
+            size_t prevPid = findField(line, event, " prev_pid=");
+            size_t prevPrio = findField(line, event, " prev_prio=");
+            size_t nextComm = findField(line, event, " next_comm=");
+            size_t nextPid = findField(line, event, " next_pid=");
+            size_t nextPrio = findField(line, event, " next_prio=");
+            if(prevPid == string::npos || nextPid == string::npos || prevComm == string::npos || nextComm == string::npos)
+                continue;
+
+            const char* p = line.c_str() + prevPid;
+            int pid = parseInt(p);
+            if(pid != 0)
+            {
+                TaskRecord& rec = lookupTask(tasks, procList, name, pid, line, prevComm, prevPid - strlen(" prev_pid="), now);
+                if(rec.lastIn >= 0)
+                    rec.cpuNs += now - rec.lastIn;
+                rec.lastIn = -1;
+                if(prevPrio != string::npos)
+                {
+                    p = line.c_str() + prevPrio;
+                    procList[rec.idx].priority = priorityFromPrio(parseInt(p));
+                }
+            }
+            p = line.c_str() + nextPid;
+            pid = parseInt(p);
+            if(pid != 0)
+            {
+                TaskRecord& rec = lookupTask(tasks, procList, name, pid, line, nextComm, nextPid - strlen(" next_pid="), now);
+                rec.lastIn = now;
+                if(nextPrio != string::npos)
+                {
+                    p = line.c_str() + nextPrio;
+                    procList[rec.idx].priority = priorityFromPrio(parseInt(p));
+                }
+            }
+        }
+        else
+        {
+            //sched_wakeup / sched_wakeup_new: comm=A pid=1 prio=120 target_cpu=000
+            size_t comm = findField(line, event, " comm=");
+            size_t pidPos = findField(line, event, " pid=");
+            if(comm == string::npos || pidPos == string::npos)
+                continue;
+            const char* p = line.c_str() + pidPos;
+            int pid = parseInt(p);
+            if(pid != 0)
+                lookupTask(tasks, procList, name, pid, line, comm, pidPos - strlen(" pid="), now);
+        }
+    }
+
+    //tasks still on a CPU at the end of the trace ran until the last event
+    for(auto& entry: tasks)
+    {
+        TaskRecord& rec = entry.second;
+        if(rec.lastIn >= 0)
+            rec.cpuNs += lastTs - rec.lastIn;
+        procList[rec.idx].startTime = (rec.first - firstTs) / tickNs;
+        procList[rec.idx].totalTimeNeeded = toTicks(rec.cpuNs, tickNs);
+    }
+    return true;
+}
+
+bool importSchedstat(const string& fname, vector<Process>& procList, long long tickNs)
+{
+    ifstream in;
+    vector<char> buffer;
+    if(!openTrace(fname, in, buffer))
+        return false;
+
+    unordered_map<int, TaskRecord> tasks;
+    string line, name;
+    long long snapshotNs = 0, firstSnapshotNs = -1;
+    procList.clear();
+    tasks.reserve(1 << 16);
+
+    while(getline(in, line))
+    {
+        const char* p = line.c_str();
+        if(*p == '#')
+        {
+            //"# <seconds>" starts a new snapshot
+            ++p;
+            while(*p == ' ')
+                ++p;
+            if(*p >= '0' && *p <= '9')
+                snapshotNs = parseTimestampNs(p);
+            continue;
+        }
+
+        int pid;
+        size_t commBegin, commEnd;
+        if(strncmp(p, "/proc/", 6) == 0)
+        {
+            size_t stat = line.find("/schedstat");
+            if(stat == string::npos)
+                continue;
+            //the pid is the last path component before schedstat (the tid for /proc/<pid>/task/<tid>)
+            commEnd = stat;
+            commBegin = line.rfind('/', stat - 1) + 1;
+            p = line.c_str() + commBegin;
+            pid = parseInt(p);
+            p = line.c_str() + stat + strlen("/schedstat");
+            if(*p == ':')
+                ++p;
+        }
+        else
+        {
+            while(*p == ' ')
+                ++p;
+            commBegin = p - line.c_str();
+            pid = parseInt(p);
+            commEnd = p - line.c_str();
+        }
+        if(commEnd == commBegin)
+            continue;
+
+        while(*p == ' ')
+            ++p;
+        long long run = parseInt(p);
+        if(firstSnapshotNs < 0)
+            firstSnapshotNs = snapshotNs;
+
+        //schedstat has no command name, so the process id is "pid-<pid>"
+        TaskRecord& rec = lookupTask(tasks, procList, name, pid, PID_NAME, 0, PID_NAME.size(), snapshotNs);
+        if(rec.snapshots++ == 0)
+            rec.firstRun = run;
+        rec.lastRun = run;
+    }
+
+    for(auto& entry: tasks)
+    {
+        TaskRecord& rec = entry.second;
+        long long cpuNs = rec.snapshots > 1 ? rec.lastRun - rec.firstRun : rec.lastRun;
+        procList[rec.idx].startTime = (rec.first - firstSnapshotNs) / tickNs;
+        procList[rec.idx].totalTimeNeeded = toTicks(cpuNs, tickNs);
+    }
+    return true;
+}
+
+void readInWorkload(const string& fname, vector<Process>& procList, long long tickNs)
+{
+    ifstream in(fname.c_str());
+    string line;
+
+    if(in.fail())
+    {
+        cerr << "Unable to open file \"" << fname << "\", terminating" << endl;
+        exit(-1);
+    }
+
+    //look at the first data line to tell the formats apart: a process list starts with the
+    //process count alone on a line
+    while(getline(in, line) && (line.empty() || line[0] == '#'))
+        ;
+    in.close();
+    size_t last = line.find_last_not_of(" \t\r");
+    bool singleToken = last != string::npos && line.find_first_of(" \t", line.find_first_not_of(" \t")) > last;
+
+    bool loaded = true;
+    if(line.find("sched_switch") != string::npos || line.find("sched_wakeup") != string::npos)
+        loaded = importSchedTrace(fname, procList, tickNs);
+    else if(line.find("schedstat") != string::npos || !singleToken)
+        loaded = importSchedstat(fname, procList, tickNs);
+    else
+        readInProcList(fname, procList);
+
+    if(!loaded)
+    {
+        cerr << "Unable to read trace \"" << fname << "\", terminating" << endl;
+        exit(-1);
+    }
+}
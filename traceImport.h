@@ -0,0 +1,29 @@
+#ifndef TRACEIMPORT_H
+#define TRACEIMPORT_H
+
+#include "schedulers.h"
+
+//Importers that turn real Linux scheduling traces into a process list. Both read the dump in a
+//single streaming pass, keeping one record per task, so they work on dumps far larger than memory.
+
+//default length of one simulated time unit when importing traces: 1 ms
+const long long TRACE_TICK_NS = 1000000;
+
+//Reads a text dump of sched_switch / sched_wakeup events, as written by
+//"perf sched script" or by the ftrace trace / trace_pipe files.
+//Each task becomes a process that arrives when it is first seen, needs its total on-CPU time
+//and has a priority derived from its nice value. Returns false if the file can't be opened.
+bool importSchedTrace(const string& fname, vector<Process>& procList, long long tickNs = TRACE_TICK_NS);
+
+//Reads /proc/<pid>/schedstat snapshots, one task per line, either as "grep -H" output
+//("/proc/<pid>/schedstat:<run ns> <wait ns> <timeslices>") or as "<pid> <run ns> <wait ns> <timeslices>".
+//A line "# <seconds>" starts a new snapshot taken at that time. A task arrives at the first
+//snapshot it appears in and needs the CPU time it accumulated between its first and last snapshot
+//(or its total run time if it appears only once). Returns false if the file can't be opened.
+bool importSchedstat(const string& fname, vector<Process>& procList, long long tickNs = TRACE_TICK_NS);
+
+//Reads a process list, sched trace or schedstat dump, telling them apart by their first data line.
+//Terminates like readInProcList if the file can't be read.
+void readInWorkload(const string& fname, vector<Process>& procList, long long tickNs = TRACE_TICK_NS);
+
+#endif
@@ -0,0 +1,51 @@
+#include<random>   // perturbations
+#include<cmath>    // lround
+#include "workloadOverlay.h"
+
+WorkloadOverlay::WorkloadOverlay(const vector<Process>& base, const Perturbation& perturbation, long long seed) : base(&base)
+{
+    mt19937 random(seed);
+    uniform_real_distribution<double> unit(0, 1), factor(1 - perturbation.burstNoise, 1 + perturbation.burstNoise);
+    uniform_int_distribution<int> jitter(-perturbation.arrivalJitter, perturbation.arrivalJitter);
+    for(uint32_t i = 0; i < base.size(); ++i)
+    {
+        const Process& p = base[i];
+        if(perturbation.arrivalJitter > 0)
+        {
+            int start = max(p.startTime + jitter(random), 0);
+            if(start != p.startTime)
+                edits.push_back({i, START, start});
+        }
+        if(perturbation.priorityFlips > 0 && unit(random) < perturbation.priorityFlips)
+            edits.push_back({i, PRIORITY, p.priority == 0 ? 1 : 0});
+        if(perturbation.burstNoise > 0)
+        {
+            int scale = static_cast<int>(lround(estimateScale(p) * factor(random)));
+            if(scale != estimateScale(p))
+                edits.push_back({i, ESTIMATE, scale});
+        }
+    }
+}
+
+void WorkloadOverlay::apply(vector<Process>& procList) const
+{
+    procList = *base;
+    vector<int> bursts;
+    for(const Edit& edit: edits)
+    {
+        Process& p = procList[edit.process];
+        if(edit.field == START)
+            p.startTime = edit.value;
+        else if(edit.field == PRIORITY)
+            p.priority = edit.value;
+        else
+        {
+            //the entry is copied with the new scale
+            bursts.clear();
+            if(p.extras && burstPool()[p.extras + 1] != END_OF_BURSTS)
+                for(uint32_t i = p.extras + 1; burstPool()[i] != END_OF_BURSTS; ++i)
+                    bursts.push_back(burstPool()[i]);
+            setBursts(p, workingSet(p), bursts, relativeDeadline(p), processGroup(p), edit.value);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef WORKLOADOVERLAY_H
+#define WORKLOADOVERLAY_H
+
+#include<vector>
+#include<cstdint>
+#include "schedulers.h"
+
+using namespace std;
+
+//How replicas of a workload are perturbed: each process's CPU burst estimates scaled by a factor
+//drawn uniformly from 1 - burstNoise..1 + burstNoise (see setBursts(); the bursts themselves keep
+//their true lengths, so only the policies that order by estimates see the error), each arrival
+//moved by up to arrivalJitter either way, and each priority flipped between foreground and background with
+//probability priorityFlips: 0 becomes 1 and any other priority 0, as the multilevel queues and
+//modified HRRN only treat priority 0 as foreground
+struct Perturbation
+{
+    Perturbation() : burstNoise(0), arrivalJitter(0), priorityFlips(0) {}
+
+    double burstNoise;
+    int arrivalJitter;
+    double priorityFlips;
+
+    bool any() const { return burstNoise > 0 || arrivalJitter > 0 || priorityFlips > 0; }
+};
+
+//A perturbed replica of a base workload that records only the fields the perturbation changed, so
+//thousands of replicas cost little more than the changes themselves. The base is only read and
+//must outlive the overlay.
+class WorkloadOverlay
+{
+public:
+    //the replica of base the perturbation draws from seed
+    WorkloadOverlay(const vector<Process>& base, const Perturbation& perturbation, long long seed);
+
+    //Writes the replica to procList: the base with the changes applied. Processes whose estimates
+    //changed get a new entry appended to the burst pool, so it isn't thread-safe; the entries can
+    //be dropped again by cutting the pool back once procList is done with.
+    void apply(vector<Process>& procList) const;
+
+    //number of fields changed
+    size_t size() const { return edits.size(); }
+
+private:
+    //a changed field of a process: its start time, its priority or its estimate scale
+    static const int START = -1;
+    static const int PRIORITY = -2;
+    static const int ESTIMATE = -3;
+    struct Edit
+    {
+        uint32_t process;
+        int field;      //START, PRIORITY or ESTIMATE
+        int value;
+    };
+
+    const vector<Process>* base;
+    vector<Edit> edits;     //in process order
+};
+
+#endif